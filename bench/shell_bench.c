@@ -0,0 +1,405 @@
+/**
+ * ********************************************************
+ * \file      shell_bench.c
+ * \brief     shell core throughput & latency benchmark
+ * \version   1.6
+ * \author    awesome
+ * \copyright (c) 2026, AWESOME
+ * ********************************************************
+ * \note      revision note
+ * |   Date    |  version  |  author   | Description
+ * |2026-10-18 |    1.0    |  awesome  | init version
+ * |2026-10-18 |    1.1    |  awesome  | lock cost
+ * |2026-10-18 |    1.2    |  awesome  | log queue cost
+ * |2026-10-18 |    1.3    |  awesome  | captured run cost
+ * |2026-10-18 |    1.4    |  awesome  | cmd index sized to table
+ * |2026-10-18 |    1.5    |  awesome  | single match tab cost
+ * |2026-10-18 |    1.6    |  awesome  | tagged cmd cost
+ * ********************************************************
+ * \note      host build, table size by SHELL_BENCH_CMDS
+ *            (10, 100, 1000, 10000), the cmd index must hold
+ *            the whole table, so SHELL_CMD_INDEX_MAX is raised
+ *   gcc -std=gnu99 -O2 -I. -DSHELL_BENCH_CMDS=1000
+ *       -DSHELL_CMD_INDEX_MAX=16384 -DSHELL_USING_LOG=1
+ *       -DSHELL_USING_LOCK=1
+ *       bench/shell_bench.c shell.c shell_number.c shell_log.c
+ *       -lpthread -o shell_bench
+ *   ./shell_bench > result.json
+ *            with the cmd hash table, same flags
+ *   gcc -std=gnu99 -O2 -I. -DSHELL_BENCH_CMDS=1000
+ *       -DSHELL_CMD_INDEX_MAX=16384 -DSHELL_USING_LOG=1
+ *       -DSHELL_USING_LOCK=1 -E
+ *       bench/shell_bench.c shell.c
+ *       | python3 tools/shell_cmd_hash.py -o shell_cmd_hash.c
+ *   gcc ... shell_cmd_hash.c -lpthread -o shell_bench
+ * ********************************************************
+ */
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "shell.h"
+
+#ifndef SHELL_BENCH_CMDS
+#define SHELL_BENCH_CMDS                   100         /**< synthetic cmd num */
+#endif
+
+#ifndef SHELL_BENCH_LOOPS
+#define SHELL_BENCH_LOOPS                  20000       /**< loops per case */
+#endif
+
+/*-----------------------------------------------------------------------------*/
+/*! in memory write sink */
+static struct {
+    uint64_t bytes;                        /**< bytes written */
+    uint64_t writes;                       /**< write calls */
+} bench_sink;
+
+static shell_t bench_shell;
+#if SHELL_USING_LOG == 1
+static shell_log_t bench_log;
+#endif /** SHELL_USING_LOG == 1 */
+static char bench_buffer[512];
+static volatile int bench_result;
+static uint64_t bench_prints;
+
+static signed short bench_write(char *data, uint16_t size)
+{
+    (void)data;
+    bench_sink.bytes += size;
+    bench_sink.writes++;
+    return size;
+}
+
+static uint64_t bench_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/*-----------------------------------------------------------------------------*/
+/*! synthetic commands */
+static int bench_main(int argc, char *argv[])
+{
+    bench_result = argc;
+    return 0;
+}
+
+static int bench_func(int a, int b)
+{
+    bench_result = a + b;
+    return 0;
+}
+
+SHELL_EXPORT_CMD(SHELL_CMD_PERMISSION(0) | SHELL_CMD_TYPE(SHELL_TYPE_CMD_MAIN) |
+                 SHELL_CMD_DISABLE_RETURN, bmain, bench_main, bench main cmd);
+static int bench_typed(float a, double b, int64_t c)
+{
+    bench_result = (a == 0.5f && b == 1e300 && c == INT64_MIN) ? 1 : -1;
+    return 0;
+}
+
+SHELL_EXPORT_CMD(SHELL_CMD_PERMISSION(0) | SHELL_CMD_TYPE(SHELL_TYPE_CMD_FUNC) |
+                 SHELL_CMD_DISABLE_RETURN, bfunc, bench_func, bench func cmd);
+SHELL_EXPORT_CMD_TAGGED(SHELL_CMD_PERMISSION(0) | SHELL_CMD_DISABLE_RETURN,
+                        btyped, bench_typed, bench tagged cmd, float, double, int64_t);
+
+/*! table entries c0, c00 ... expanded by digit */
+#define BENCH_CMD(n) \
+        SHELL_EXPORT_CMD(SHELL_CMD_PERMISSION(0) | SHELL_CMD_TYPE(SHELL_TYPE_CMD_MAIN) | \
+                         SHELL_CMD_DISABLE_RETURN, n, bench_main, bench cmd);
+#define BENCH_X10(p)    BENCH_CMD(p##0) BENCH_CMD(p##1) BENCH_CMD(p##2) BENCH_CMD(p##3) \
+                        BENCH_CMD(p##4) BENCH_CMD(p##5) BENCH_CMD(p##6) BENCH_CMD(p##7) \
+                        BENCH_CMD(p##8) BENCH_CMD(p##9)
+#define BENCH_X100(p)   BENCH_X10(p##0) BENCH_X10(p##1) BENCH_X10(p##2) BENCH_X10(p##3) \
+                        BENCH_X10(p##4) BENCH_X10(p##5) BENCH_X10(p##6) BENCH_X10(p##7) \
+                        BENCH_X10(p##8) BENCH_X10(p##9)
+#define BENCH_X1000(p)  BENCH_X100(p##0) BENCH_X100(p##1) BENCH_X100(p##2) BENCH_X100(p##3) \
+                        BENCH_X100(p##4) BENCH_X100(p##5) BENCH_X100(p##6) BENCH_X100(p##7) \
+                        BENCH_X100(p##8) BENCH_X100(p##9)
+#define BENCH_X10000(p) BENCH_X1000(p##0) BENCH_X1000(p##1) BENCH_X1000(p##2) BENCH_X1000(p##3) \
+                        BENCH_X1000(p##4) BENCH_X1000(p##5) BENCH_X1000(p##6) BENCH_X1000(p##7) \
+                        BENCH_X1000(p##8) BENCH_X1000(p##9)
+
+#if SHELL_BENCH_CMDS == 10
+BENCH_X10(c)
+#define BENCH_LAST                         "c9"
+#define BENCH_PREFIX                       "c"
+#elif SHELL_BENCH_CMDS == 100
+BENCH_X100(c)
+#define BENCH_LAST                         "c99"
+#define BENCH_PREFIX                       "c9"
+#elif SHELL_BENCH_CMDS == 1000
+BENCH_X1000(c)
+#define BENCH_LAST                         "c999"
+#define BENCH_PREFIX                       "c99"
+#elif SHELL_BENCH_CMDS == 10000
+BENCH_X10000(c)
+#define BENCH_LAST                         "c9999"
+#define BENCH_PREFIX                       "c999"
+#else
+#error "SHELL_BENCH_CMDS must be 10, 100, 1000 or 10000"
+#endif
+
+/*! table and builtin cmds must fit the index, or seek & tab walk the table */
+#if SHELL_USING_CMD_INDEX == 1 && SHELL_CMD_INDEX_MAX < SHELL_BENCH_CMDS + 64
+#error "build with -DSHELL_CMD_INDEX_MAX above SHELL_BENCH_CMDS"
+#endif
+
+#if SHELL_USING_LOCK == 1
+/*-----------------------------------------------------------------------------*/
+/*! lock hooks as the linux port sets them */
+static pthread_mutex_t bench_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+static int bench_printing;
+
+static int bench_lock(shell_t *shell)
+{
+    (void)shell;
+    return pthread_mutex_lock(&bench_mutex);
+}
+
+static int bench_unlock(shell_t *shell)
+{
+    (void)shell;
+    return pthread_mutex_unlock(&bench_mutex);
+}
+
+/**
+ * @brief another task printing while the shell takes input
+ */
+static void *bench_print_task(void *param)
+{
+    uint64_t prints = 0;
+
+    while(__atomic_load_n(&bench_printing, __ATOMIC_RELAXED)) {
+        shell_print(&bench_shell, "log %d\r\n", (int)prints);
+        prints++;
+    }
+    bench_prints = prints;
+    return NULL;
+}
+#endif /** SHELL_USING_LOCK == 1 */
+
+/*-----------------------------------------------------------------------------*/
+static void bench_feed(const char *data)
+{
+    while(*data) {
+        shell_handler(&bench_shell, *data++);
+    }
+}
+
+static void bench_clear_line(void)
+{
+    while(bench_shell.parser.cursor < bench_shell.parser.length) {
+        bench_feed("\033[C");
+    }
+    while(bench_shell.parser.length) {
+        shell_handler(&bench_shell, 0x08);
+    }
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      type a line then erase it
+ * @return     ns per keystroke
+ * -----------------------------------------------
+ */
+static double bench_keystroke(const char *line, size_t length)
+{
+    uint64_t start = bench_ns();
+    for(int i = 0; i < SHELL_BENCH_LOOPS / 10; i++) {
+        bench_feed(line);
+        bench_clear_line();
+    }
+    return (double)(bench_ns() - start) / (SHELL_BENCH_LOOPS / 10 * length * 2);
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      run a shell_run case
+ * @return     ns per command
+ * -----------------------------------------------
+ */
+static double bench_run(const char *cmd)
+{
+    uint64_t start = bench_ns();
+    for(int i = 0; i < SHELL_BENCH_LOOPS; i++) {
+        shell_run(&bench_shell, cmd);
+    }
+    return (double)(bench_ns() - start) / SHELL_BENCH_LOOPS;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      run a tab completion case, timing tab only
+ * @return     ns per tab
+ * -----------------------------------------------
+ */
+static double bench_tab(const char *prefix)
+{
+    uint64_t elapsed = 0;
+    uint64_t start;
+    for(int i = 0; i < SHELL_BENCH_LOOPS / 10; i++) {
+        bench_feed(prefix);
+        start = bench_ns();
+        shell_handler(&bench_shell, '\t');
+        elapsed += bench_ns() - start;
+        bench_clear_line();
+    }
+    return (double)elapsed / (SHELL_BENCH_LOOPS / 10);
+}
+
+#if SHELL_CAPTURE_LINE_MAX > 0
+/**
+ * -----------------------------------------------
+ * @brief      run a shell_run_capture case
+ * @return     ns per command
+ * -----------------------------------------------
+ */
+static double bench_capture(const char *cmd)
+{
+    static char output[256];
+    int ret;
+    uint64_t start = bench_ns();
+    for(int i = 0; i < SHELL_BENCH_LOOPS; i++) {
+        shell_run_capture(&bench_shell, cmd, output, sizeof(output), &ret);
+    }
+    return (double)(bench_ns() - start) / SHELL_BENCH_LOOPS;
+}
+#endif /** SHELL_CAPTURE_LINE_MAX > 0 */
+
+int main(void)
+{
+    static const char line[] = "abcdefghijklmnopqrstuvwxyz012345";
+    static const char text[] = "0123456789abcdef0123456789abcdef"
+                               "0123456789abcdef0123456789abcde\n";
+    double keystroke_ns, edit_ns, main_ns, func_ns, seek_ns, miss_ns, tab_ns, tab_one_ns, output_bps;
+    uint64_t start, elapsed, bytes, writes;
+    double cmd_writes, edit_bytes;
+    double lock_ns = 0, contended_ns = 0;
+    double print_line_bytes = 0, log_line_bytes = 0, log_push_ns = 0;
+    double capture_ns = 0;
+    double typed_ns;
+    int typed_ok;
+#if SHELL_USING_LOCK == 1
+    pthread_t printer;
+#endif /** SHELL_USING_LOCK == 1 */
+
+    bench_shell.write = bench_write;
+    shell_init(&bench_shell, bench_buffer, sizeof(bench_buffer));
+    bench_feed(SHELL_DEFAULT_USER_PASSWORD "\r");
+
+    /*! keystroke: type a line then erase it */
+    keystroke_ns = bench_keystroke(line, sizeof(line) - 1);
+
+    /*! mid line edit: insert and delete at the head of a typed line */
+    elapsed = 0;
+    bytes = 0;
+    for(int i = 0; i < SHELL_BENCH_LOOPS / 10; i++) {
+        bench_feed(line);
+        for(size_t j = 0; j < sizeof(line) - 1; j++) {
+            bench_feed("\033[D");
+        }
+        writes = bench_sink.bytes;
+        start = bench_ns();
+        for(size_t j = 0; j < sizeof(line) - 1; j++) {
+            shell_handler(&bench_shell, line[j]);
+            shell_handler(&bench_shell, 0x08);
+        }
+        elapsed += bench_ns() - start;
+        bytes += bench_sink.bytes - writes;
+        bench_clear_line();
+    }
+    edit_ns = (double)elapsed / (SHELL_BENCH_LOOPS / 10 * (sizeof(line) - 1) * 2);
+    edit_bytes = (double)bytes / (SHELL_BENCH_LOOPS / 10 * (sizeof(line) - 1) * 2);
+
+    /*! dispatch */
+    main_ns = bench_run("bmain 1 2 3");
+    func_ns = bench_run("bfunc 1 2");
+    seek_ns = bench_run(BENCH_LAST);
+    miss_ns = bench_run("zzzz");
+    typed_ns = bench_run("btyped 0.5 1e300 -9223372036854775808");
+    typed_ok = (bench_result == 1);
+    /*! float overflow is refused before the call */
+    bench_result = 0;
+    shell_run(&bench_shell, "btyped 1e39 1 1");
+    typed_ok = typed_ok && (bench_result == 0);
+#if SHELL_CAPTURE_LINE_MAX > 0
+    capture_ns = bench_capture("bmain 1 2 3");
+#endif /** SHELL_CAPTURE_LINE_MAX > 0 */
+
+    writes = bench_sink.writes;
+    shell_run(&bench_shell, "bmain 1 2 3");
+    cmd_writes = (double)(bench_sink.writes - writes);
+
+    /*! tab completion, listing 11 matches, then completing the only one */
+    tab_ns = bench_tab(BENCH_PREFIX);
+    tab_one_ns = bench_tab(BENCH_LAST);
+
+    /*! output */
+    bytes = bench_sink.bytes;
+    start = bench_ns();
+    for(int i = 0; i < SHELL_BENCH_LOOPS; i++) {
+        shell_print(&bench_shell, "%s", text);
+    }
+    elapsed = bench_ns() - start;
+    output_bps = (double)(bench_sink.bytes - bytes) * 1e9 / elapsed;
+
+#if SHELL_USING_LOG == 1
+    /*! log lines over a typed line, printed one by one or queued */
+    bench_feed(line);
+    bytes = bench_sink.bytes;
+    for(int i = 0; i < SHELL_BENCH_LOOPS; i++) {
+        shell_print(&bench_shell, "log %d\r\n", i);
+    }
+    print_line_bytes = (double)(bench_sink.bytes - bytes) / SHELL_BENCH_LOOPS;
+    shell_log_init(&bench_log);
+    bench_shell.log = &bench_log;
+    elapsed = 0;
+    bytes = bench_sink.bytes;
+    for(int i = 0; i < SHELL_BENCH_LOOPS; i++) {
+        start = bench_ns();
+        shell_log_print(&bench_log, 0, "log %d\r\n", i);
+        elapsed += bench_ns() - start;
+        if((i + 1) % SHELL_LOG_QUEUE_SIZE == 0) {
+            shell_write_log(&bench_shell);
+        }
+    }
+    shell_write_log(&bench_shell);
+    log_line_bytes = (double)(bench_sink.bytes - bytes) / SHELL_BENCH_LOOPS;
+    log_push_ns = (double)elapsed / SHELL_BENCH_LOOPS;
+    bench_shell.log = NULL;
+    bench_clear_line();
+#endif /** SHELL_USING_LOG == 1 */
+
+#if SHELL_USING_LOCK == 1
+    /*! same keystrokes with pthread lock hooks, then with a task printing */
+    bench_shell.lock = bench_lock;
+    bench_shell.unlock = bench_unlock;
+    lock_ns = bench_keystroke(line, sizeof(line) - 1);
+    __atomic_store_n(&bench_printing, 1, __ATOMIC_RELAXED);
+    pthread_create(&printer, NULL, bench_print_task, NULL);
+    contended_ns = bench_keystroke(line, sizeof(line) - 1);
+    __atomic_store_n(&bench_printing, 0, __ATOMIC_RELAXED);
+    pthread_join(printer, NULL);
+    bench_shell.lock = NULL;
+    bench_shell.unlock = NULL;
+#endif /** SHELL_USING_LOCK == 1 */
+
+    printf("{\"cmds\":%d,\"loops\":%d,"
+           "\"keystroke_ns\":%.1f,\"edit_ns\":%.1f,\"edit_bytes_per_key\":%.1f,"
+           "\"main_ns\":%.1f,\"func_ns\":%.1f,\"typed_ns\":%.1f,\"typed_ok\":%d,\"capture_ns\":%.1f,"
+           "\"seek_last_ns\":%.1f,\"seek_miss_ns\":%.1f,\"tab_ns\":%.1f,\"tab_one_ns\":%.1f,"
+           "\"writes_per_cmd\":%.1f,\"output_bytes_per_s\":%.0f,"
+           "\"lock_keystroke_ns\":%.1f,\"contended_keystroke_ns\":%.1f,"
+           "\"contended_prints\":%llu,"
+           "\"print_line_bytes\":%.1f,\"log_line_bytes\":%.1f,\"log_push_ns\":%.1f}\n",
+           SHELL_BENCH_CMDS, SHELL_BENCH_LOOPS,
+           keystroke_ns, edit_ns, edit_bytes, main_ns, func_ns, typed_ns, typed_ok, capture_ns, seek_ns, miss_ns, tab_ns, tab_one_ns,
+           cmd_writes, output_bps, lock_ns, contended_ns,
+           (unsigned long long)bench_prints,
+           print_line_bytes, log_line_bytes, log_push_ns);
+    return 0;
+}
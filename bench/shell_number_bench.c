@@ -0,0 +1,312 @@
+/**
+ * ********************************************************
+ * \file      shell_number_bench.c
+ * \brief     numeric param parser benchmark
+ * \version   1.1
+ * \author    awesome
+ * \copyright (c) 2026, AWESOME
+ * ********************************************************
+ * \note      revision note
+ * |   Date    |  version  |  author   | Description
+ * |2026-10-18 |    1.0    |  awesome  | init version
+ * |2026-10-18 |    1.1    |  awesome  | real overflow cases
+ * ********************************************************
+ * \note      host build, compares shell_number with the
+ *            previous per char parser and with strtod
+ *   gcc -std=gnu99 -O2 -I. bench/shell_number_bench.c
+ *       shell_number.c -o shell_number_bench
+ *   ./shell_number_bench > result.json
+ * ********************************************************
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "shell_number.h"
+
+#ifndef SHELL_NUMBER_BENCH_LOOPS
+#define SHELL_NUMBER_BENCH_LOOPS           200000      /**< loops per case */
+#endif
+
+static volatile uint64_t bench_sink;
+
+static uint64_t bench_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/*-----------------------------------------------------------------------------*/
+/*! previous parser, kept as reference */
+static char legacy_char_to_num(char code)
+{
+    if ((code >= '0') && (code <= '9'))
+    {
+        return code - '0';
+    }
+    else if ((code >= 'a') && (code <= 'f'))
+    {
+        return code - 'a' + 10;
+    }
+    else if ((code >= 'A') && (code <= 'F'))
+    {
+        return code - 'A' + 10;
+    }
+    return 0;
+}
+
+enum {
+    LEGACY_DEC,
+    LEGACY_BIN,
+    LEGACY_OCT,
+    LEGACY_HEX,
+    LEGACY_FLOAT
+};
+
+static int legacy_num_type(char *string)
+{
+    char *p = string;
+    int type = LEGACY_DEC;
+
+    if ((*p == '0') && ((*(p + 1) == 'x') || (*(p + 1) == 'X')))
+    {
+        type = LEGACY_HEX;
+    }
+    else if ((*p == '0') && ((*(p + 1) == 'b') || (*(p + 1) == 'B')))
+    {
+        type = LEGACY_BIN;
+    }
+    else if (*p == '0')
+    {
+        type = LEGACY_OCT;
+    }
+
+    while (*p++)
+    {
+        if (*p == '.' && *(p + 1) != 0)
+        {
+            type = LEGACY_FLOAT;
+            break;
+        }
+    }
+
+    return type;
+}
+
+static size_t legacy_parse_number(char *string)
+{
+    int type = LEGACY_DEC;
+    char radix = 10;
+    char *p = string;
+    char offset = 0;
+    signed char sign = 1;
+    size_t value_int = 0;
+    float value_float = 0.0;
+    size_t devide = 0;
+    size_t result = 0;
+
+    if (*string == '-')
+    {
+        sign = -1;
+    }
+
+    type = legacy_num_type(string + ((sign == -1) ? 1 : 0));
+
+    switch (type)
+    {
+    case LEGACY_HEX:
+        radix = 16;
+        offset = 2;
+        break;
+
+    case LEGACY_OCT:
+        radix = 8;
+        offset = 1;
+        break;
+
+    case LEGACY_BIN:
+        radix = 2;
+        offset = 2;
+        break;
+
+    default:
+        break;
+    }
+
+    p = string + offset + ((sign == -1) ? 1 : 0);
+
+    while (*p)
+    {
+        if (*p == '.')
+        {
+            devide = 1;
+            p++;
+            continue;
+        }
+        value_int = value_int * radix + legacy_char_to_num(*p);
+        devide *= 10;
+        p++;
+    }
+    if (type == LEGACY_FLOAT && devide != 0)
+    {
+        value_float = (float)value_int / devide * sign;
+        memcpy(&result, &value_float, sizeof(value_float));
+        return result;
+    }
+    return value_int * sign;
+}
+
+/*-----------------------------------------------------------------------------*/
+/*! typical shell params */
+static char *bench_int[] = {
+    "0", "7", "42", "-1", "1000", "65535", "-32768", "0x1F", "0xDEADBEEF",
+    "0b1011", "017", "123456789", "-987654321", "4294967295",
+};
+
+static char *bench_real[] = {
+    "0.5", "3.14159", "-2.75", "100.25", "0.001", "12345.678", "-0.125",
+    "1.1", "99.99", "0.3",
+};
+
+#define BENCH_COUNT(a)                     (sizeof(a) / sizeof((a)[0]))
+
+static double bench_legacy(char **set, size_t count)
+{
+    uint64_t start = bench_ns();
+    for (int i = 0; i < SHELL_NUMBER_BENCH_LOOPS; i++)
+    {
+        bench_sink += legacy_parse_number(set[i % count]);
+    }
+    return (double)(bench_ns() - start) / SHELL_NUMBER_BENCH_LOOPS;
+}
+
+static double bench_number(char **set, size_t count, int real)
+{
+    shell_number_t number;
+    float value;
+    uint64_t start = bench_ns();
+    for (int i = 0; i < SHELL_NUMBER_BENCH_LOOPS; i++)
+    {
+        shell_number_parse(set[i % count], &number);
+        if (real)
+        {
+            shell_number_float(&number, &value);
+            bench_sink += (uint64_t)(value * 1000);
+        }
+        else
+        {
+            bench_sink += (uint64_t)shell_number_int(&number);
+        }
+    }
+    return (double)(bench_ns() - start) / SHELL_NUMBER_BENCH_LOOPS;
+}
+
+static double bench_strtod(char **set, size_t count)
+{
+    uint64_t start = bench_ns();
+    for (int i = 0; i < SHELL_NUMBER_BENCH_LOOPS; i++)
+    {
+        bench_sink += (uint64_t)(strtod(set[i % count], NULL) * 1000);
+    }
+    return (double)(bench_ns() - start) / SHELL_NUMBER_BENCH_LOOPS;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      random reals checked against strtod
+ *             and strtof, the reference of exactness
+ * @return     mismatch count
+ * -----------------------------------------------
+ */
+static int bench_exact(int count)
+{
+    char string[48];
+    shell_number_t number;
+    double value;
+    float value_float;
+    int mismatch = 0;
+
+    srand(1);
+    for (int i = 0; i < count; i++)
+    {
+        snprintf(string, sizeof(string), "%s%d.%0*de%d",
+                 (rand() & 1) ? "-" : "", rand() % 100000,
+                 rand() % 9 + 1, rand() % 100000000, rand() % 61 - 30);
+        if (shell_number_parse(string, &number) != SHELL_NUMBER_OK ||
+            shell_number_double(&number, &value) != SHELL_NUMBER_OK ||
+            shell_number_float(&number, &value_float) != SHELL_NUMBER_OK ||
+            value != strtod(string, NULL) || value_float != strtof(string, NULL))
+        {
+            mismatch++;
+        }
+    }
+    return mismatch;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      values the previous parser got wrong
+ * @return     count still wrong
+ * -----------------------------------------------
+ */
+static int bench_overflow(void)
+{
+    static const struct {
+        char *string;
+        SHELL_NUMBER_ERROR_E error;
+        int64_t value;
+    } cases[] = {
+        {"9223372036854775807", SHELL_NUMBER_OK, INT64_MAX},
+        {"-9223372036854775808", SHELL_NUMBER_OK, INT64_MIN},
+        {"18446744073709551616", SHELL_NUMBER_ERROR_OVERFLOW, 0},
+        {"0x10000000000000000", SHELL_NUMBER_ERROR_OVERFLOW, 0},
+        {"-9223372036854775809", SHELL_NUMBER_ERROR_OVERFLOW, 0},
+        {"12a", SHELL_NUMBER_ERROR_DIGIT, 0},
+        {"09", SHELL_NUMBER_ERROR_DIGIT, 0},
+        {"0b102", SHELL_NUMBER_ERROR_DIGIT, 0},
+        {"-", SHELL_NUMBER_ERROR_EMPTY, 0},
+        {"0x", SHELL_NUMBER_ERROR_EMPTY, 0},
+    };
+    shell_number_t number;
+    double value;
+    float value_float;
+    int wrong = 0;
+
+    for (size_t i = 0; i < BENCH_COUNT(cases); i++)
+    {
+        if (shell_number_parse(cases[i].string, &number) != cases[i].error ||
+            (cases[i].error == SHELL_NUMBER_OK &&
+             shell_number_int(&number) != cases[i].value))
+        {
+            wrong++;
+        }
+    }
+    /*! real beyond its type is overflow, not inf */
+    shell_number_parse("1e400", &number);
+    wrong += shell_number_double(&number, &value) != SHELL_NUMBER_ERROR_OVERFLOW;
+    shell_number_parse("-1e39", &number);
+    wrong += shell_number_float(&number, &value_float) != SHELL_NUMBER_ERROR_OVERFLOW;
+    wrong += shell_number_double(&number, &value) != SHELL_NUMBER_OK;
+    return wrong;
+}
+
+int main(void)
+{
+    double legacy_int_ns, legacy_real_ns, int_ns, real_ns, strtod_ns;
+
+    legacy_int_ns = bench_legacy(bench_int, BENCH_COUNT(bench_int));
+    legacy_real_ns = bench_legacy(bench_real, BENCH_COUNT(bench_real));
+    int_ns = bench_number(bench_int, BENCH_COUNT(bench_int), 0);
+    real_ns = bench_number(bench_real, BENCH_COUNT(bench_real), 1);
+    strtod_ns = bench_strtod(bench_real, BENCH_COUNT(bench_real));
+
+    printf("{\"loops\":%d,"
+           "\"legacy_int_ns\":%.1f,\"legacy_real_ns\":%.1f,"
+           "\"int_ns\":%.1f,\"real_ns\":%.1f,\"strtod_ns\":%.1f,"
+           "\"real_mismatch\":%d,\"edge_wrong\":%d}\n",
+           SHELL_NUMBER_BENCH_LOOPS,
+           legacy_int_ns, legacy_real_ns, int_ns, real_ns, strtod_ns,
+           bench_exact(100000), bench_overflow());
+    return 0;
+}
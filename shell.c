@@ -13,6 +13,19 @@
  * |2025-10-31 |    1.1    |  Awesome  | modify to c style
  * |2025-11-03 |    1.2    |  Awesome  | merge ext.c to shell.c
  * |2026-01-27 |    1.2    |  Awesome  | modify section setting
+ * |2026-10-18 |    1.2    |  Awesome  | add gnu ld section bounds
+ * |2026-10-18 |    1.2    |  Awesome  | use shell_number param parser
+ * |2026-10-18 |    1.2    |  Awesome  | gap buffer line editor
+ * |2026-10-18 |    1.2    |  Awesome  | packed history arena
+ * |2026-10-18 |    1.2    |  Awesome  | ctrl-r reverse history search
+ * |2026-10-18 |    1.2    |  Awesome  | persistent history log
+ * |2026-10-18 |    1.2    |  Awesome  | shell lock hooks, async print
+ * |2026-10-18 |    1.2    |  Awesome  | log queue drained by shell task
+ * |2026-10-18 |    1.2    |  Awesome  | key section, cold descriptions
+ * |2026-10-18 |    1.2    |  Awesome  | perfect hash cmd seek
+ * |2026-10-18 |    1.2    |  Awesome  | visible bitmap of current user
+ * |2026-10-18 |    1.2    |  Awesome  | runtime cmd & key registration
+ * |2026-10-18 |    1.2    |  Awesome  | run cmd into caller buffer
  * ********************************************************
  */
 #include <string.h>
@@ -20,20 +33,40 @@
 #include <stdarg.h>
 #include "shell.h"
 #include "shell_cfg.h"
+#include "shell_number.h"
 
 /*-----------------------------------------------------------------------------*/
-/*! shell command section address */
-#if 0 
+/*! shell command & key section address, see SHELL_SECTION_BOUNDS,
+    not weak, a script without the key section must fail to link */
+#if SHELL_SECTION_BOUNDS == 2
 extern const unsigned int _shell_command_start;
 extern const unsigned int _shell_command_end;
-const uint32_t shell_sec_start = (uint32_t)&_shell_command_start;
-const uint32_t shell_sec_end = (uint32_t)&_shell_command_end;
+extern const unsigned int _shell_key_start;
+extern const unsigned int _shell_key_end;
+const size_t shell_sec_start = (size_t)&_shell_command_start;
+const size_t shell_sec_end = (size_t)&_shell_command_end;
+const size_t shell_key_start = (size_t)&_shell_key_start;
+const size_t shell_key_end = (size_t)&_shell_key_end;
+#elif SHELL_SECTION_BOUNDS == 1
+/*! gnu ld provides bounds of sections named as c identifier */
+extern const shell_cmd_t __start_shell_sec[];
+extern const shell_cmd_t __stop_shell_sec[];
+extern const shell_cmd_t __start_shell_key[];
+extern const shell_cmd_t __stop_shell_key[];
+const size_t shell_sec_start = (size_t)__start_shell_sec;
+const size_t shell_sec_end = (size_t)__stop_shell_sec;
+const size_t shell_key_start = (size_t)__start_shell_key;
+const size_t shell_key_end = (size_t)__stop_shell_key;
 #else
 extern const uint32_t shell_sec$$Base;
 extern const uint32_t shell_sec$$Limit;
-const uint32_t shell_sec_start = &shell_sec$$Base;
-const uint32_t shell_sec_end  = &shell_sec$$Limit;
-#endif /**< __GNUC__ */
+extern const uint32_t shell_key$$Base;
+extern const uint32_t shell_key$$Limit;
+const size_t shell_sec_start = (size_t)&shell_sec$$Base;
+const size_t shell_sec_end = (size_t)&shell_sec$$Limit;
+const size_t shell_key_start = (size_t)&shell_key$$Base;
+const size_t shell_key_end = (size_t)&shell_key$$Limit;
+#endif /**< SHELL_SECTION_BOUNDS */
 /*-----------------------------------------------------------------------------*/
 /**
  * -----------------------------------------
@@ -42,7 +75,7 @@ const uint32_t shell_sec_end  = &shell_sec$$Limit;
  * */
 const char shell_default_user[] = SHELL_DEFAULT_USER;
 const char shell_default_user_password[] = SHELL_DEFAULT_USER_PASSWORD;
-const char shell_default_user_desc[] = "default user";
+const char shell_default_user_desc[] SHELL_SECTION(SHELL_DESC_SEC_NAME) = "default user";
 const shell_cmd_t shell_default_user_cmd SHELL_USED SHELL_SECTION(SHELL_SEC_NAME) =
 {
     .attr.value = SHELL_CMD_PERMISSION(0) | SHELL_CMD_TYPE(SHELL_TYPE_USER),
@@ -112,6 +145,12 @@ static const char *shell_text[] =
         "KEY ",
     [SHELL_TEXT_TYPE_NONE] =
         "NONE",
+    [SHELL_TEXT_INDEX_FULL] =
+        "\r\nWarning: cmd index full, raise SHELL_CMD_INDEX_MAX\r\n",
+    [SHELL_TEXT_KEY_EMPTY] =
+        "\r\nError: no key in shell_key section, check linker script\r\n",
+    [SHELL_TEXT_KEY_MAP_FULL] =
+        "\r\nWarning: key map full, raise SHELL_KEY_MAP_MAX\r\n",
 };
 /*-----------------------------------------------------------------------------*/
 uint8_t pairedChars[][2] = {
@@ -131,6 +170,87 @@ static shell_t *shell_list[SHELL_MAX_NUMBER] = {
     NULL
 };
 /*-----------------------------------------------------------------------------*/
+#if SHELL_USING_DYNAMIC == 1
+/*! shell runtime records, owned by caller until unregistered */
+static struct {
+    const shell_cmd_t *cmd[SHELL_DYNAMIC_MAX];     /**< cmd/var/user, in registration order */
+    const shell_cmd_t *key[SHELL_DYNAMIC_KEY_MAX]; /**< key, in registration order */
+    uint16_t cmd_count;                        /**< cmd/var/user num */
+    uint8_t key_count;                         /**< key num */
+} shell_dynamic;
+
+#define SHELL_DYNAMIC_CMD_COUNT     shell_dynamic.cmd_count
+#define SHELL_CMD_INDEX_SIZE        (SHELL_CMD_INDEX_MAX + SHELL_DYNAMIC_MAX)
+#else
+#define SHELL_DYNAMIC_CMD_COUNT     0
+#define SHELL_CMD_INDEX_SIZE        SHELL_CMD_INDEX_MAX
+#endif /** SHELL_USING_DYNAMIC == 1 */
+
+/*! item of section before base, runtime records follow the section */
+#define SHELL_BEFORE_BASE(item, base) \
+        ((size_t)(item) >= shell_sec_start && (size_t)(item) < (size_t)(base))
+
+#if SHELL_USING_CMD_INDEX == 1
+/*! shell cmd index, cmd/var/user sorted by name, then by address */
+static struct {
+    shell_cmd_t *item[SHELL_CMD_INDEX_SIZE];  /**< sorted cmd item, room for runtime records */
+    uint16_t count;                            /**< indexed item num */
+    uint8_t is_valid;                          /**< index built and usable */
+} shell_cmd_index;
+#endif /** SHELL_USING_CMD_INDEX == 1 */
+
+#if SHELL_USING_CMD_HASH == 1
+/*! shell cmd perfect hash, from tools/shell_cmd_hash.py,
+    weak since a build may not link the generated table */
+extern const shell_cmd_hash_t shell_cmd_hash __attribute__((weak));
+
+/*! generated table matches section, checked once and shared by all shell */
+static uint8_t shell_cmd_hash_valid;
+#endif /** SHELL_USING_CMD_HASH == 1 */
+
+#if SHELL_USING_KEY_MAP == 1
+/*! shell key map transition */
+struct shell_key_edge {
+    uint8_t state;                             /**< from state */
+    uint8_t next;                              /**< next state */
+    char data;                                 /**< input byte */
+    shell_cmd_t *key;                          /**< key ends at this byte */
+};
+
+/*! shell key map, keys compiled into a byte transition table */
+static struct {
+    uint32_t lead[8];                          /**< bitmap of key first byte */
+    struct shell_key_edge edge[SHELL_KEY_MAP_MAX]; /**< sorted by state & byte */
+    uint8_t first[SHELL_KEY_MAP_MAX + 2];      /**< first edge of state */
+    uint8_t count;                             /**< edge num */
+    uint8_t state_count;                       /**< state num */
+    uint8_t is_valid;                          /**< key map built and usable */
+} shell_key_map;
+#endif /** SHELL_USING_KEY_MAP == 1 */
+
+#if SHELL_USING_CMD_STATS == 1
+/*! shell cmd execution stats, time in SHELL_GET_HRTICK tick */
+static struct shell_cmd_stat {
+    const shell_cmd_t *cmd;                    /**< cmd, NULL if slot unused */
+    uint32_t count;                            /**< call count */
+    uint32_t last;                             /**< last execution time */
+    uint32_t min;                              /**< min execution time */
+    uint32_t max;                              /**< max execution time */
+    uint32_t hist[SHELL_CMD_STATS_BUCKETS];    /**< bucket n counts time in [2^(n-1), 2^n) */
+} shell_cmd_stats[SHELL_CMD_STATS_MAX];
+
+/*! stats are shared by all shell and callers of shell_register_run */
+static uint8_t shell_cmd_stats_busy;
+
+#define SHELL_STATS_TRY_LOCK()      (!__atomic_test_and_set(&shell_cmd_stats_busy, __ATOMIC_ACQUIRE))
+#define SHELL_STATS_UNLOCK()        __atomic_clear(&shell_cmd_stats_busy, __ATOMIC_RELEASE)
+#define SHELL_STATS_START()         uint32_t stats_start = SHELL_GET_HRTICK()
+#define SHELL_STATS_STOP(cmd)       shell_cmd_stats_record(cmd, SHELL_GET_HRTICK() - stats_start)
+#else
+#define SHELL_STATS_START()
+#define SHELL_STATS_STOP(cmd)
+#endif /** SHELL_USING_CMD_STATS == 1 */
+/*-----------------------------------------------------------------------------*/
 /*! shell func declaraiton */
 static void shell_add(shell_t *shell);
 static void shell_write_prompt(shell_t *shell, uint8_t newline);
@@ -138,6 +258,31 @@ static void shell_write_return_value(shell_t *shell, int value);
 static int shell_show_var(shell_t *shell, shell_cmd_t *command);
 static void shell_set_user(shell_t *shell, const shell_cmd_t *user);
 static void shell_write_cmd_help(shell_t *shell, char *cmd);
+#if SHELL_USING_CMD_INDEX == 1
+static void shell_build_cmd_index(shell_t *shell);
+#endif /** SHELL_USING_CMD_INDEX == 1 */
+#if SHELL_USING_CMD_HASH == 1
+static void shell_check_cmd_hash(shell_t *shell);
+#endif /** SHELL_USING_CMD_HASH == 1 */
+#if SHELL_HISTORY_MAX_NUMBER > 0 && SHELL_HISTORY_PERSIST == 1
+static void shell_history_log_load(shell_t *shell);
+#endif
+#if SHELL_SUPPORT_END_LINE == 1 || SHELL_USING_LOCK == 1
+static void shell_write_async(shell_t *shell, const char *data, uint16_t length);
+#endif
+#if SHELL_USING_KEY_MAP == 1
+static void shell_build_key_map(shell_t *shell);
+#endif /** SHELL_USING_KEY_MAP == 1 */
+static int shell_register_call(shell_cmd_t *command, size_t *params, int param_number);
+#if SHELL_USING_CMD_STATS == 1
+static void shell_cmd_stats_record(const shell_cmd_t *command, uint32_t time);
+#if SHELL_USING_DYNAMIC == 1
+static void shell_cmd_stats_remove(const shell_cmd_t *command);
+#endif /** SHELL_USING_DYNAMIC == 1 */
+#endif /** SHELL_USING_CMD_STATS == 1 */
+#if SHELL_USING_RPC == 1
+static uint16_t shell_rpc_input(shell_t *shell, const char *data, uint16_t length);
+#endif /** SHELL_USING_RPC == 1 */
 /*-----------------------------------------------------------------------------*/
 /*-----------------------------------------------------------------------------*/
 /*-------------               shell basic function         --------------------*/
@@ -194,6 +339,114 @@ shell_t *shell_get_current(void)
     return NULL;
 }
 
+/**
+ * -----------------------------------------------
+ * @brief      flush staged output to shell
+ * -----------------------------------------------
+ * @param[in]  shell: shell obj
+ * -----------------------------------------------
+ */
+void shell_write_flush(shell_t *shell)
+{
+    if(shell->output.length && !shell->output.capture) {
+        shell->write(shell->output.buffer, shell->output.length);
+        shell->output.length = 0;
+    }
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      write data to shell
+ * @details    data is staged while the shell is handling
+ *             input or running command, and written through
+ *             in any other context, captured output beyond
+ *             the buffer is dropped
+ * -----------------------------------------------
+ * @param[in]  shell : shell obj
+ * @param[in]  data  : data to write
+ * @param[in]  length: data length
+ * @return     num of bytes written
+ * -----------------------------------------------
+ */
+static uint16_t shell_write_data(shell_t *shell, const char *data, uint16_t length)
+{
+    if(shell->output.capture) {
+        if(length > shell->output.size - shell->output.length) {
+            length = shell->output.size - shell->output.length;
+        }
+        memcpy(shell->output.buffer + shell->output.length, data, length);
+        shell->output.length += length;
+        return length;
+    }
+    if(!shell->output.hold || length >= shell->output.size) {
+        shell_write_flush(shell);
+        return shell->write((char *)data, length);
+    }
+    if(length > shell->output.size - shell->output.length) {
+        shell_write_flush(shell);
+    }
+    memcpy(shell->output.buffer + shell->output.length, data, length);
+    shell->output.length += length;
+    return length;
+}
+
+#if SHELL_CAPTURE_LINE_MAX > 0 || SHELL_USING_RPC == 1
+/*! output state kept while output is captured */
+typedef struct {
+    char *buffer;                          /**< staging buffer */
+    uint16_t size;                         /**< staging buffer size */
+    uint16_t length;                       /**< staged length */
+    uint8_t capture;                       /**< capture of outer */
+} shell_output_save_t;
+
+/**
+ * -----------------------------------------------
+ * @brief      shell capture begin
+ * @details    write output straight into buffer from now,
+ *             output staged before is written first, or
+ *             kept if an outer capture owns it
+ * -----------------------------------------------
+ * @param[in]  shell : shell obj
+ * @param[out] save  : output state to restore
+ * @param[in]  buffer: capture buffer
+ * @param[in]  size  : capture buffer size
+ * -----------------------------------------------
+ */
+static void shell_capture_begin(shell_t *shell, shell_output_save_t *save,
+                                char *buffer, uint16_t size)
+{
+    shell_write_flush(shell);
+    save->buffer = shell->output.buffer;
+    save->size = shell->output.size;
+    save->length = shell->output.length;
+    save->capture = shell->output.capture;
+    shell->output.buffer = buffer;
+    shell->output.size = size;
+    shell->output.length = 0;
+    shell->output.capture = 1;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell capture end
+ * -----------------------------------------------
+ * @param[in]  shell : shell obj
+ * @param[in]  save  : output state of shell_capture_begin
+ * @return     captured length
+ * -----------------------------------------------
+ */
+static uint16_t shell_capture_end(shell_t *shell, const shell_output_save_t *save)
+{
+    uint16_t length = shell->output.length;
+
+    shell->output.buffer = save->buffer;
+    shell->output.size = save->size;
+    shell->output.length = save->length;
+    shell->output.capture = save->capture;
+    return length;
+}
+#endif /** SHELL_CAPTURE_LINE_MAX > 0 || SHELL_USING_RPC == 1 */
+
 /**
  * -----------------------------------------------
  * @brief      write byte to shell
@@ -204,7 +457,7 @@ shell_t *shell_get_current(void)
  */
 static void shell_write_byte(shell_t *shell, char data)
 {
-    shell->write(&data, 1);
+    shell_write_data(shell, &data, 1);
 }
 
 /**
@@ -226,7 +479,7 @@ uint16_t shell_write_string(shell_t *shell, const char *string)
     while(*p++) {
         count++;
     }
-    return shell->write((char *)string, count);
+    return shell_write_data(shell, string, count);
 }
 
 /**
@@ -251,10 +504,10 @@ static uint16_t shell_write_cmd_desc(shell_t *shell, const char *string)
     }
 
     if(count > 36) {
-        shell->write((char *)string, 36);
-        shell->write("...", 3);
+        shell_write_data(shell, string, 36);
+        shell_write_data(shell, "...", 3);
     } else {
-        shell->write((char *)string, count);
+        shell_write_data(shell, string, count);
     }
     return count > 36 ? 36 : 39;
 }
@@ -284,6 +537,7 @@ static void shell_write_prompt(shell_t *shell, uint8_t newline)
     } else {
         shell_write_string(shell, shell_text[SHELL_TEXT_PASSWORD_HINT]);
     }
+    shell_write_flush(shell);
 }
 
 #if SHELL_PRINT_BUFFER > 0
@@ -309,7 +563,17 @@ void shell_print(shell_t *shell, const char *fmt, ...)
     if(len > SHELL_PRINT_BUFFER) {
         len = SHELL_PRINT_BUFFER;
     }
-    shell->write(buffer, len);
+    SHELL_LOCK(shell);
+#if SHELL_USING_LOCK == 1
+    /*! not inside shell input or cmd, keep the input line */
+    if(!shell->output.hold) {
+        shell_write_async(shell, buffer, len);
+    } else
+#endif /** SHELL_USING_LOCK == 1 */
+    {
+        shell_write_data(shell, buffer, len);
+    }
+    SHELL_UNLOCK(shell);
 }
 
 #endif
@@ -333,7 +597,8 @@ void shell_scan(shell_t *shell, char *fmt, ...)
     if(shell->read) {
         do{
             if(shell->read(&buffer[index], 1) == 1) {
-                shell->write(&buffer[index], 1);
+                shell_write_data(shell, &buffer[index], 1);
+                shell_write_flush(shell);
                 index++;
             }
         } while(buffer[index - 1] != '\r' && buffer[index - 1] != '\n' &&
@@ -349,6 +614,26 @@ void shell_scan(shell_t *shell, char *fmt, ...)
 
 #endif
 
+/**
+ * -----------------------------------------------
+ * @brief      shell check user
+ * @details    whether user may use command, password aside
+ * -----------------------------------------------
+ * @param[in]  user   : user, may be NULL
+ * @param[in]  command: shell_cmd_t
+ * @return     1: allowed
+ * @return     0: not allowed
+ * -----------------------------------------------
+ */
+static uint8_t shell_check_user(const shell_cmd_t *user, const shell_cmd_t *command)
+{
+    return (!command->attr.para.permission ||
+            command->attr.para.type == SHELL_TYPE_USER ||
+            (user && (command->attr.para.permission & user->attr.para.permission)))
+               ? 1
+               : 0;
+}
+
 /**
  * -----------------------------------------------
  * @brief      shell check permission
@@ -361,16 +646,187 @@ void shell_scan(shell_t *shell, char *fmt, ...)
  */
 signed char shell_check_permission(shell_t *shell, shell_cmd_t *command)
 {
-    return ((!command->attr.para.permission ||
-             command->attr.para.type == SHELL_TYPE_USER ||
-             (shell->info.sh_cmd &&
-              (command->attr.para.permission &
-               shell->info.sh_cmd->attr.para.permission))) &&
+    return (shell_check_user(shell->info.sh_cmd, command) &&
             (shell->status.is_checked || command->attr.para.enable_unchecked))
                ? 0
                : -1;
 }
 
+#if SHELL_USING_VISIBLE_MAP == 1
+/*! trailing zero count of non-zero word */
+#if defined(__GNUC__)
+#define SHELL_CTZ(x)                __builtin_ctz(x)
+#else
+static uint8_t shell_ctz(uint32_t x)
+{
+    uint8_t n = 0;
+    while(!(x & 1)) {
+        x >>= 1;
+        n++;
+    }
+    return n;
+}
+#define SHELL_CTZ(x)                shell_ctz(x)
+#endif
+
+/**
+ * -----------------------------------------------
+ * @brief      shell mark visible
+ * @details    set bit n of checked and unchecked row by
+ *             the permission of user
+ * -----------------------------------------------
+ * @param[in]  bit    : bitmap, row 0 unchecked, row 1 checked
+ * @param[in]  words  : words of a row
+ * @param[in]  n      : item position
+ * @param[in]  user   : current user, may be NULL
+ * @param[in]  command: item
+ * -----------------------------------------------
+ */
+static void shell_mark_visible(uint32_t *bit, uint16_t words, uint16_t n,
+                               const shell_cmd_t *user, const shell_cmd_t *command)
+{
+    if(shell_check_user(user, command)) {
+        bit[words + (n >> 5)] |= 1UL << (n & 31);
+        if(command->attr.para.enable_unchecked) {
+            bit[n >> 5] |= 1UL << (n & 31);
+        }
+    }
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell build visible
+ * @details    bitmap of cmd/var/user and key visible to current
+ *             user, once per user switch, so scans test a bit
+ *             instead of the permission of each item
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * -----------------------------------------------
+ */
+static void shell_build_visible(shell_t *shell)
+{
+    const shell_cmd_t *user = shell->info.sh_cmd;
+    const shell_cmd_t *base;
+
+    memset(&shell->visible, 0, sizeof(shell->visible));
+    base = shell->command_list.base;
+    for(uint16_t i = 0; i < shell->command_list.count && i < SHELL_VISIBLE_MAP_MAX; i++) {
+        shell_mark_visible(shell->visible.cmd[0], sizeof(shell->visible.cmd[0]) / 4,
+                           i, user, &base[i]);
+    }
+    base = shell->key_list.base;
+    for(uint16_t i = 0; i < shell->key_list.count && i < SHELL_VISIBLE_KEY_MAX; i++) {
+        shell_mark_visible(shell->visible.key[0], sizeof(shell->visible.key[0]) / 4,
+                           i, user, &base[i]);
+    }
+}
+#endif /** SHELL_USING_VISIBLE_MAP == 1 */
+
+/**
+ * -----------------------------------------------
+ * @brief      shell next visible
+ * @details    first item from n visible to current user,
+ *             a word of hidden items skipped at once
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * @param[in]  base  : item list
+ * @param[in]  count : item num
+ * @param[in]  bit   : visible row of session, NULL if none
+ * @param[in]  bits  : items with bit
+ * @param[in]  n     : first position
+ * -----------------------------------------------
+ * @return     uint16_t : position of item, count if none
+ * -----------------------------------------------
+ */
+static inline uint16_t shell_next_visible(shell_t *shell, const shell_cmd_t *base, uint16_t count,
+                                          const uint32_t *bit, uint16_t bits, uint16_t n)
+{
+    const shell_cmd_t *user = shell->info.sh_cmd;
+    uint8_t checked = shell->status.is_checked;
+#if SHELL_USING_VISIBLE_MAP == 1
+    uint32_t word;
+
+    while(n < count && n < bits) {
+        /*! bits past count are clear */
+        word = bit[n >> 5] & (0xFFFFFFFFUL << (n & 31));
+        if(word) {
+            return (n & ~31) + SHELL_CTZ(word);
+        }
+        n = (n | 31) + 1;
+    }
+#else
+    (void)bit;
+    (void)bits;
+#endif /** SHELL_USING_VISIBLE_MAP == 1 */
+    /*! same as shell_check_permission */
+    while(n < count &&
+          !(shell_check_user(user, &base[n]) &&
+            (checked || base[n].attr.para.enable_unchecked)))
+    {
+        n++;
+    }
+    return n < count ? n : count;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell is visible
+ * @details    whether item is visible to current user,
+ *             item out of list or bitmap is checked itself
+ * -----------------------------------------------
+ * @param[in]  shell  : shell struct
+ * @param[in]  base   : item list
+ * @param[in]  count  : item num
+ * @param[in]  bit    : visible row of session, NULL if none
+ * @param[in]  bits   : items with bit
+ * @param[in]  command: item
+ * -----------------------------------------------
+ * @return     uint8_t : 1 visible, 0 hidden
+ * -----------------------------------------------
+ */
+static uint8_t shell_is_visible(shell_t *shell, const shell_cmd_t *base, uint16_t count,
+                                const uint32_t *bit, uint16_t bits, const shell_cmd_t *command)
+{
+#if SHELL_USING_VISIBLE_MAP == 1
+    size_t n = ((size_t)command - (size_t)base) / sizeof(shell_cmd_t);
+
+    if(n < count && n < bits) {
+        return (bit[n >> 5] >> (n & 31)) & 1;
+    }
+#else
+    (void)base;
+    (void)count;
+    (void)bit;
+    (void)bits;
+#endif /** SHELL_USING_VISIBLE_MAP == 1 */
+    return shell_check_permission(shell, (shell_cmd_t *)command) == 0;
+}
+
+#if SHELL_USING_VISIBLE_MAP == 1
+#define SHELL_VISIBLE_CMD(shell)    (shell)->visible.cmd[(shell)->status.is_checked], SHELL_VISIBLE_MAP_MAX
+#define SHELL_VISIBLE_KEY(shell)    (shell)->visible.key[(shell)->status.is_checked], SHELL_VISIBLE_KEY_MAX
+#else
+#define SHELL_VISIBLE_CMD(shell)    NULL, 0
+#define SHELL_VISIBLE_KEY(shell)    NULL, 0
+#endif /** SHELL_USING_VISIBLE_MAP == 1 */
+
+/*! first cmd/var/user or key from n visible to current user */
+#define SHELL_NEXT_CMD(shell, n)    shell_next_visible(shell, (shell)->command_list.base,      \
+                                                       (shell)->command_list.count,         \
+                                                       SHELL_VISIBLE_CMD(shell), n)
+#define SHELL_NEXT_KEY(shell, n)    shell_next_visible(shell, (shell)->key_list.base,          \
+                                                       (shell)->key_list.count,             \
+                                                       SHELL_VISIBLE_KEY(shell), n)
+
+/*! whether cmd/var/user or key is visible to current user */
+#define SHELL_CMD_VISIBLE(shell, command)                                                  \
+        shell_is_visible(shell, (shell)->command_list.base, (shell)->command_list.count,  \
+                         SHELL_VISIBLE_CMD(shell), command)
+#define SHELL_KEY_VISIBLE(shell, key)                                                      \
+        shell_is_visible(shell, (shell)->key_list.base, (shell)->key_list.count,          \
+                         SHELL_VISIBLE_KEY(shell), key)
+
+
 /**
  * -----------------------------------------------
  * @brief      shell int covert hex
@@ -499,6 +955,13 @@ static const char *shell_get_command_name(shell_cmd_t *command)
         return command->data.var.name;
     } else if(command->attr.para.type <= SHELL_TYPE_USER) {
         return command->data.user.name;
+    } else if(command->attr.para.sequence) {
+        int value = 0;
+        for(uint8_t i = 0; i < 4 && command->data.key.seq[i]; i++) {
+            value |= (uint8_t)command->data.key.seq[i] << (24 - 8 * i);
+        }
+        shell_to_hex(value, buffer);
+        return buffer;
     } else {
         shell_to_hex(command->data.key.value, buffer);
         return buffer;
@@ -547,24 +1010,78 @@ void shell_init(shell_t *shell, char *buffer, uint16_t size)
     shell->parser.length = 0;
     shell->parser.cursor = 0;
     shell->parser.buffer = buffer;
-    shell->parser.buffer_size = size / (SHELL_HISTORY_MAX_NUMBER + 1);
+    shell->parser.buffer_size = size;
+    shell->parser.key_value = 0;
+#if SHELL_HISTORY_MAX_NUMBER > 0
+    /*! history arena set before shell_init, else taken from buffer tail */
+    if(shell->history.buffer == NULL || shell->history.size == 0) {
+        shell->history.size = (size / 2 < SHELL_HISTORY_BUFFER) ? size / 2
+                                                                : SHELL_HISTORY_BUFFER;
+        shell->parser.buffer_size = size - shell->history.size;
+        shell->history.buffer = buffer + shell->parser.buffer_size;
+    }
+#endif /** SHELL_HISTORY_MAX_NUMBER > 0 */
+    shell->parser.key_state = 0;
     
+    /*! shell output init */
+#if SHELL_OUTPUT_BUFFER > 0
+    shell->output.buffer = shell->output.data;
+    shell->output.size = SHELL_OUTPUT_BUFFER;
+#else
+    shell->output.buffer = NULL;
+    shell->output.size = 0;
+#endif
+    shell->output.length = 0;
+    shell->output.hold = 0;
+
     /*! shell status init */
     shell->status.is_checked = 1;
     
+#if SHELL_HISTORY_MAX_NUMBER > 0
     /*! shell history init */
-    shell->history.offset = 0;
+    shell->history.head = 0;
+    shell->history.tail = 0;
+    shell->history.used = 0;
     shell->history.number = 0;
     shell->history.record = 0;
-    for(short i = 0; i < SHELL_HISTORY_MAX_NUMBER; i++) {
-        shell->history.item[i] = buffer + shell->parser.buffer_size * (i + 1);
-    }
+    shell->history.offset = 0;
+#if SHELL_HISTORY_SEARCH == 1
+    shell->history.first = 0;
+    shell->history.match = 0;
+    shell->history.search = 0;
+    shell->history.pattern_length = 0;
+#endif /** SHELL_HISTORY_SEARCH == 1 */
+#if SHELL_HISTORY_PERSIST == 1
+    shell_history_log_load(shell);
+#endif /** SHELL_HISTORY_PERSIST == 1 */
+#endif /** SHELL_HISTORY_MAX_NUMBER > 0 */
 
     /*! shell command list init */
     shell->command_list.base = (shell_cmd_t *)(shell_sec_start);
     shell->command_list.count =
         ((size_t)(shell_sec_end) - (size_t)(shell_sec_start)) /
         sizeof(shell_cmd_t);
+    shell->key_list.base = (shell_cmd_t *)(shell_key_start);
+    shell->key_list.count =
+        ((size_t)(shell_key_end) - (size_t)(shell_key_start)) /
+        sizeof(shell_cmd_t);
+    if(shell->key_list.count == 0) {
+        /*! not even enter, the console would be dead */
+        shell_write_string(shell, shell_text[SHELL_TEXT_KEY_EMPTY]);
+    }
+#if SHELL_USING_CMD_INDEX == 1
+    shell_build_cmd_index(shell);
+#endif /** SHELL_USING_CMD_INDEX == 1 */
+#if SHELL_USING_CMD_HASH == 1
+    shell_check_cmd_hash(shell);
+#endif /** SHELL_USING_CMD_HASH == 1 */
+#if SHELL_USING_KEY_MAP == 1
+    shell_build_key_map(shell);
+#endif /** SHELL_USING_KEY_MAP == 1 */
+#if SHELL_USING_VISIBLE_MAP == 1
+    /*! no user yet, users are visible to seek the default one */
+    shell_build_visible(shell);
+#endif /** SHELL_USING_VISIBLE_MAP == 1 */
 
     shell_add(shell);
 
@@ -618,6 +1135,43 @@ void shell_list_item(shell_t *shell, shell_cmd_t *item)
 }
 
 
+#if SHELL_USING_DYNAMIC == 1
+/**
+ * -----------------------------------------------
+ * @brief      shell list dynamic
+ * @details    list runtime records of type first to last
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * @param[in]  first : first type
+ * @param[in]  last  : last type
+ * -----------------------------------------------
+ */
+static void shell_list_dynamic(shell_t *shell, uint8_t first, uint8_t last)
+{
+    const shell_cmd_t *item;
+
+    if(first == SHELL_TYPE_KEY) {
+        for(uint8_t i = 0; i < shell_dynamic.key_count; i++) {
+            if(SHELL_KEY_VISIBLE(shell, shell_dynamic.key[i])) {
+                shell_list_item(shell, (shell_cmd_t *)shell_dynamic.key[i]);
+            }
+        }
+        return;
+    }
+    for(uint16_t i = 0; i < shell_dynamic.cmd_count; i++) {
+        item = shell_dynamic.cmd[i];
+        if(item->attr.para.type >= first && item->attr.para.type <= last &&
+           SHELL_CMD_VISIBLE(shell, item))
+        {
+            shell_list_item(shell, (shell_cmd_t *)item);
+        }
+    }
+}
+#define SHELL_LIST_DYNAMIC(shell, first, last)  shell_list_dynamic(shell, first, last)
+#else
+#define SHELL_LIST_DYNAMIC(shell, first, last)
+#endif /** SHELL_USING_DYNAMIC == 1 */
+
 /**
  * -----------------------------------------------
  * @brief      shell list command
@@ -630,13 +1184,14 @@ void shell_list_command(shell_t *shell)
 {
     shell_cmd_t *base = (shell_cmd_t *)shell->command_list.base;
     shell_write_string(shell, shell_text[SHELL_TEXT_CMD_LIST]);
-    for(short i = 0; i < shell->command_list.count; i++) {
-        if(base[i].attr.para.type <= SHELL_TYPE_CMD_FUNC &&
-           shell_check_permission(shell, &base[i]) == 0)
-        {
+    for(uint16_t i = SHELL_NEXT_CMD(shell, 0); i < shell->command_list.count;
+        i = SHELL_NEXT_CMD(shell, i + 1))
+    {
+        if(base[i].attr.para.type <= SHELL_TYPE_CMD_FUNC) {
             shell_list_item(shell, &base[i]);
         }
     }
+    SHELL_LIST_DYNAMIC(shell, SHELL_TYPE_CMD_MAIN, SHELL_TYPE_CMD_FUNC);
 }
 
 /**
@@ -651,14 +1206,16 @@ void shell_list_var(shell_t *shell)
 {
     shell_cmd_t *base = (shell_cmd_t *)shell->command_list.base;
     shell_write_string(shell, shell_text[SHELL_TEXT_VAR_LIST]);
-    for(short i = 0; i < shell->command_list.count; i++) {
+    for(uint16_t i = SHELL_NEXT_CMD(shell, 0); i < shell->command_list.count;
+        i = SHELL_NEXT_CMD(shell, i + 1))
+    {
         if(base[i].attr.para.type > SHELL_TYPE_CMD_FUNC &&
-           base[i].attr.para.type <= SHELL_TYPE_VAR_NODE &&
-           shell_check_permission(shell, &base[i]) == 0)
+           base[i].attr.para.type <= SHELL_TYPE_VAR_NODE)
         {
             shell_list_item(shell, &base[i]);
         }
     }
+    SHELL_LIST_DYNAMIC(shell, SHELL_TYPE_VAR_INT, SHELL_TYPE_VAR_NODE);
 }
 
 /**
@@ -673,14 +1230,16 @@ void shell_list_user(shell_t *shell)
 {
     shell_cmd_t *base = (shell_cmd_t *)shell->command_list.base;
     shell_write_string(shell, shell_text[SHELL_TEXT_USER_LIST]);
-    for(short i = 0; i < shell->command_list.count; i++) {
+    for(uint16_t i = SHELL_NEXT_CMD(shell, 0); i < shell->command_list.count;
+        i = SHELL_NEXT_CMD(shell, i + 1))
+    {
         if(base[i].attr.para.type > SHELL_TYPE_VAR_NODE &&
-           base[i].attr.para.type <= SHELL_TYPE_USER &&
-           shell_check_permission(shell, &base[i]) == 0)
+           base[i].attr.para.type <= SHELL_TYPE_USER)
         {
             shell_list_item(shell, &base[i]);
         }
     }
+    SHELL_LIST_DYNAMIC(shell, SHELL_TYPE_USER, SHELL_TYPE_USER);
 }
 
 /**
@@ -693,16 +1252,14 @@ void shell_list_user(shell_t *shell)
  */
 void shell_list_key(shell_t *shell)
 {
-    shell_cmd_t *base = (shell_cmd_t *)shell->command_list.base;
+    shell_cmd_t *base = (shell_cmd_t *)shell->key_list.base;
     shell_write_string(shell, shell_text[SHELL_TEXT_KEY_LIST]);
-    for(short i = 0; i < shell->command_list.count; i++) {
-        if(base[i].attr.para.type > SHELL_TYPE_USER &&
-           base[i].attr.para.type <= SHELL_TYPE_KEY &&
-           shell_check_permission(shell, &base[i]) == 0)
-        {
-            shell_list_item(shell, &base[i]);
-        }
+    for(uint16_t i = SHELL_NEXT_KEY(shell, 0); i < shell->key_list.count;
+        i = SHELL_NEXT_KEY(shell, i + 1))
+    {
+        shell_list_item(shell, &base[i]);
     }
+    SHELL_LIST_DYNAMIC(shell, SHELL_TYPE_KEY, SHELL_TYPE_KEY);
 }
 
 /**
@@ -727,6 +1284,81 @@ void shell_list_all(shell_t *shell)
 #endif
 }
 
+/*-----------------------------------------------------------------------------*/
+/*! line is a gap buffer, text after cursor sits at the end of parser buffer */
+#define SHELL_LINE_TAIL(shell)      ((uint16_t)((shell)->parser.length - (shell)->parser.cursor))
+#define SHELL_LINE_TAIL_PTR(shell)  ((shell)->parser.buffer + (shell)->parser.buffer_size - \
+                                     SHELL_LINE_TAIL(shell))
+
+/**
+ * -----------------------------------------------
+ * @brief      shell write cursor
+ * @details    move terminal cursor by ansi `ESC[nX`
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * @param[in]  count : cells to move, nothing if 0
+ * @param[in]  code  : 'C' right, 'D' left, '@' insert blank
+ * -----------------------------------------------
+ */
+static void shell_write_cursor(shell_t *shell, uint16_t count, char code)
+{
+    char buffer[12];
+    char sequence[16] = "\033[";
+    signed char length;
+
+    if(count == 0) {
+        return;
+    }
+    length = shell_to_dec(count, buffer);
+    memcpy(sequence + 2, buffer + 11 - length, length);
+    sequence[2 + length] = code;
+    shell_write_data(shell, sequence, length + 3);
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell write line
+ * @details    write the whole input line, keep cursor
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * -----------------------------------------------
+ */
+static void shell_write_line(shell_t *shell)
+{
+    uint16_t tail = SHELL_LINE_TAIL(shell);
+
+    if(shell->parser.cursor) {
+        shell_write_data(shell, shell->parser.buffer, shell->parser.cursor);
+    }
+    if(tail) {
+        shell_write_data(shell, SHELL_LINE_TAIL_PTR(shell), tail);
+        shell_write_cursor(shell, tail, 'D');
+    }
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell line join
+ * @details    close the gap so the line is one string,
+ *             cursor goes to the end, terminal unchanged
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * @return     line string
+ * -----------------------------------------------
+ */
+static char *shell_line_join(shell_t *shell)
+{
+    uint16_t tail = SHELL_LINE_TAIL(shell);
+
+    if(tail) {
+        memmove(shell->parser.buffer + shell->parser.cursor,
+                SHELL_LINE_TAIL_PTR(shell), tail);
+        shell->parser.cursor = shell->parser.length;
+    }
+    shell->parser.buffer[shell->parser.length] = 0;
+    return shell->parser.buffer;
+}
+
 /**
  * -----------------------------------------------
  * @brief      shell delete command line
@@ -753,10 +1385,8 @@ void shell_delete_command_line(shell_t *shell, uint8_t length)
  */
 void shell_clear_command_line(shell_t *shell)
 {
-    for(short i = shell->parser.length - shell->parser.cursor; i > 0; i--) {
-        shell_write_byte(shell, ' ');
-    }
-    shell_delete_command_line(shell, shell->parser.length);
+    shell_write_cursor(shell, shell->parser.cursor, 'D');
+    shell_write_string(shell, "\033[K");
 }
 
 /**
@@ -774,31 +1404,43 @@ void shell_insert_byte(shell_t *shell, char data)
     if(shell->parser.length >= shell->parser.buffer_size - 1) {
         shell_write_string(shell, shell_text[SHELL_TEXT_CMD_TOO_LONG]);
         shell_write_prompt(shell, 1);
-        shell_write_string(shell, shell->parser.buffer);
+        shell_write_line(shell);
         return;
     }
 
-    /* 插入数据 */
-    if(shell->parser.cursor == shell->parser.length) {
-        shell->parser.buffer[shell->parser.length++] = data;
-        shell->parser.buffer[shell->parser.length] = 0;
-        shell->parser.cursor++;
-        shell_write_byte(shell, shell->status.is_checked ? data : '*');
-    } else if(shell->parser.cursor < shell->parser.length) {
-        for(short i = shell->parser.length - shell->parser.cursor; i > 0; i--) {
-            shell->parser.buffer[shell->parser.cursor + i] =
-                shell->parser.buffer[shell->parser.cursor + i - 1];
-        }
-        shell->parser.buffer[shell->parser.cursor++] = data;
-        shell->parser.buffer[++shell->parser.length] = 0;
-        for(short i = shell->parser.cursor - 1; i < shell->parser.length; i++) {
-            shell_write_byte(shell,
-                             shell->status.is_checked ? shell->parser.buffer[i] : '*');
-        }
-        for(short i = shell->parser.length - shell->parser.cursor; i > 0; i--) {
-            shell_write_byte(shell, '\b');
+    /* 插入数据, 光标后有内容时终端先腾出一格 */
+    shell->parser.buffer[shell->parser.cursor++] = data;
+    shell->parser.length++;
+    if(SHELL_LINE_TAIL(shell)) {
+        shell_write_string(shell, "\033[@");
+    }
+    shell_write_byte(shell, shell->status.is_checked ? data : '*');
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell insert block
+ * @details    insert bytes at cursor and echo them at once
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * @param[in]  data : insert bytes
+ * @param[in]  length : insert length
+ * -----------------------------------------------
+ */
+static void shell_insert_block(shell_t *shell, const char *data, uint16_t length)
+{
+    if(shell->parser.length + length > shell->parser.buffer_size - 1) {
+        /*! let byte insert report the overflow */
+        while(length--) {
+            shell_insert_byte(shell, *data++);
         }
+        return;
     }
+    memcpy(shell->parser.buffer + shell->parser.cursor, data, length);
+    shell->parser.length += length;
+    shell->parser.cursor += length;
+    shell_write_cursor(shell, SHELL_LINE_TAIL(shell) ? length : 0, '@');
+    shell_write_data(shell, (char *)data, length);
 }
 
 /**
@@ -812,42 +1454,24 @@ void shell_insert_byte(shell_t *shell, char data)
  */
 void shell_delete_byte(shell_t *shell, signed char direction)
 {
-    char offset = (direction == -1) ? 1 : 0;
+    uint16_t tail = SHELL_LINE_TAIL(shell);
 
     if((shell->parser.cursor == 0 && direction == 1) ||
-       (shell->parser.cursor == shell->parser.length && direction == -1))
+       (tail == 0 && direction == -1))
     {
         return;
     }
-    if(shell->parser.cursor == shell->parser.length && direction == 1) {
+    /*! dropping length takes the byte off the tail, the cursor off the head */
+    shell->parser.length--;
+    if(direction == 1) {
         shell->parser.cursor--;
-        shell->parser.length--;
-        shell->parser.buffer[shell->parser.length] = 0;
-        shell_delete_command_line(shell, 1);
-    } else {
-        for(short i = offset;
-            i < shell->parser.length - shell->parser.cursor;
-            i++)
-        {
-            shell->parser.buffer[shell->parser.cursor + i - 1] =
-                shell->parser.buffer[shell->parser.cursor + i];
-        }
-        shell->parser.length--;
-        if(!offset) {
-            shell->parser.cursor--;
-            shell_write_byte(shell, '\b');
-        }
-        shell->parser.buffer[shell->parser.length] = 0;
-        for(short i = shell->parser.cursor; i < shell->parser.length; i++) {
-            shell_write_byte(shell, shell->parser.buffer[i]);
-        }
-        shell_write_byte(shell, ' ');
-        for(short i = shell->parser.length - shell->parser.cursor + 1;
-            i > 0;
-            i--)
-        {
-            shell_write_byte(shell, '\b');
+        if(tail == 0) {
+            shell_delete_command_line(shell, 1);
+        } else {
+            shell_write_string(shell, "\b\033[P");
         }
+    } else {
+        shell_write_string(shell, "\033[P");
     }
 }
 
@@ -915,21 +1539,6 @@ int shell_split(char *string, uint16_t strLen, char *array[], char splitKey,
     return count;
 }
 
-/**
- * -----------------------------------------------
- * @brief      shell parser param
- * @details    parser shell param
- * -----------------------------------------------
- * @param[in]  shell : shell struct
- * -----------------------------------------------
- */
-static void shell_parser_param(shell_t *shell)
-{
-    shell->parser.param_count =
-        shell_split(shell->parser.buffer, shell->parser.length,
-                    shell->parser.param, ' ', SHELL_PARAMETER_MAX_NUMBER);
-}
-
 /**
  * -----------------------------------------------
  * @brief      shell remove param quotes
@@ -953,44 +1562,389 @@ static void shell_remove_param_quotes(shell_t *shell)
     }
 }
 
+#if SHELL_USING_CMD_INDEX == 1
 /**
  * -----------------------------------------------
- * @brief      shell seek cmd
- * @details    seek shell cmd
+ * @brief      shell cmd index compare
+ * @details    order by name, same name by address,
+ *             so the first match is the first in section
  * -----------------------------------------------
- * @param[in]  shell : shell struct
- * @param[in]  cmd : shell cmd
- * @param[in]  base : shell cmd base
- * @param[in]  compareLength : compare length
+ * @param[in]  a : shell cmd
+ * @param[in]  b : shell cmd
  * -----------------------------------------------
- * @return     shell_cmd_t* : shell cmd
+ * @return     int : <0 a before b, >0 a after b
  * -----------------------------------------------
  */
-shell_cmd_t *shell_seek_cmd(shell_t *shell,
-                            const char *cmd,
-                            shell_cmd_t *base,
-                            uint16_t compare_length)
+static int shell_cmd_index_compare(shell_cmd_t *a, shell_cmd_t *b)
 {
-    const char *name;
-    uint16_t count = shell->command_list.count -
-        ((size_t)base - (size_t)shell->command_list.base) / sizeof(shell_cmd_t);
-    for(uint16_t i = 0; i < count; i++) {
-        if(base[i].attr.para.type == SHELL_TYPE_KEY ||
-           shell_check_permission(shell, &base[i]) != 0)
-        {
-            continue;
-        }
-        name = shell_get_command_name(&base[i]);
+    int ret = strcmp(shell_get_command_name(a), shell_get_command_name(b));
+    if(ret == 0) {
+        ret = (a < b) ? -1 : ((a > b) ? 1 : 0);
+    }
+    return ret;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell cmd index sift down
+ * @details    heap sort helper
+ * -----------------------------------------------
+ * @param[in]  item  : index item array
+ * @param[in]  root  : heap root
+ * @param[in]  count : heap size
+ * -----------------------------------------------
+ */
+static void shell_cmd_index_sift(shell_cmd_t **item, uint16_t root, uint16_t count)
+{
+    shell_cmd_t *tmp;
+    uint32_t child;
+
+    while((child = 2 * (uint32_t)root + 1) < count) {
+        if(child + 1 < count &&
+           shell_cmd_index_compare(item[child], item[child + 1]) < 0)
+        {
+            child++;
+        }
+        if(shell_cmd_index_compare(item[root], item[child]) >= 0) {
+            return;
+        }
+        tmp = item[root];
+        item[root] = item[child];
+        item[child] = tmp;
+        root = child;
+    }
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell build cmd index
+ * @details    collect cmd/var/user of section and sort by name,
+ *             built once and shared by all shell, keys are not indexed,
+ *             a section beyond SHELL_CMD_INDEX_MAX is warned and
+ *             kept on linear seek
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * -----------------------------------------------
+ */
+static void shell_build_cmd_index(shell_t *shell)
+{
+    shell_cmd_t *base = (shell_cmd_t *)shell->command_list.base;
+    shell_cmd_t **item = shell_cmd_index.item;
+    shell_cmd_t *tmp;
+    uint16_t count = 0;
+
+    if(shell_cmd_index.is_valid) {
+        return;
+    }
+    if(shell->command_list.count > SHELL_CMD_INDEX_MAX) {
+        shell_write_string(shell, shell_text[SHELL_TEXT_INDEX_FULL]);
+        return;
+    }
+    for(uint16_t i = 0; i < shell->command_list.count; i++) {
+        item[count++] = &base[i];
+    }
+#if SHELL_USING_DYNAMIC == 1
+    for(uint16_t i = 0; i < shell_dynamic.cmd_count; i++) {
+        item[count++] = (shell_cmd_t *)shell_dynamic.cmd[i];
+    }
+#endif /** SHELL_USING_DYNAMIC == 1 */
+
+    for(uint16_t i = count / 2; i > 0; i--) {
+        shell_cmd_index_sift(item, i - 1, count);
+    }
+    for(uint16_t i = count; i > 1; i--) {
+        tmp = item[0];
+        item[0] = item[i - 1];
+        item[i - 1] = tmp;
+        shell_cmd_index_sift(item, 0, i - 1);
+    }
+    shell_cmd_index.count = count;
+    shell_cmd_index.is_valid = 1;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell cmd index lower bound
+ * @details    first index item whose leading length bytes
+ *             are not less than cmd
+ * -----------------------------------------------
+ * @param[in]  cmd    : name or name prefix
+ * @param[in]  length : compare length
+ * -----------------------------------------------
+ * @return     uint16_t : index position
+ * -----------------------------------------------
+ */
+static uint16_t shell_cmd_index_lower(const char *cmd, size_t length)
+{
+    shell_cmd_t **item = shell_cmd_index.item;
+    uint16_t low = 0;
+    uint16_t high = shell_cmd_index.count;
+    uint16_t mid;
+
+    while(low < high) {
+        mid = low + (high - low) / 2;
+        if(strncmp(item[mid]->data.cmd.name, cmd, length) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell seek cmd in index
+ * @details    binary search the sorted index,
+ *             same match rule as linear seek
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * @param[in]  cmd : shell cmd
+ * @param[in]  base : shell cmd base
+ * @param[in]  compare_length : compare length, 0 for whole name
+ * -----------------------------------------------
+ * @return     shell_cmd_t* : shell cmd
+ * -----------------------------------------------
+ */
+static shell_cmd_t *shell_seek_cmd_index(shell_t *shell,
+                                         const char *cmd,
+                                         shell_cmd_t *base,
+                                         uint16_t compare_length)
+{
+    shell_cmd_t **item = shell_cmd_index.item;
+    shell_cmd_t *match = NULL;
+    size_t length = strlen(cmd);
+    uint16_t low;
+
+    /*! compare with terminator, unless cmd is a full prefix of compare_length */
+    if(!compare_length || length < compare_length) {
+        length++;
+    } else {
+        length = compare_length;
+    }
+
+    for(low = shell_cmd_index_lower(cmd, length); low < shell_cmd_index.count &&
+          strncmp(item[low]->data.cmd.name, cmd, length) == 0;
+        low++)
+    {
+        if(SHELL_BEFORE_BASE(item[low], base) || (match && item[low] > match) ||
+           !SHELL_CMD_VISIBLE(shell, item[low]))
+        {
+            continue;
+        }
+        match = item[low];
+        if(!compare_length) {
+            break;
+        }
+    }
+    return match;
+}
+
+#if SHELL_USING_DYNAMIC == 1
+/**
+ * -----------------------------------------------
+ * @brief      shell cmd index position
+ * @details    first index item not less than command
+ * -----------------------------------------------
+ * @param[in]  command : shell cmd
+ * -----------------------------------------------
+ * @return     uint16_t : index position
+ * -----------------------------------------------
+ */
+static uint16_t shell_cmd_index_position(shell_cmd_t *command)
+{
+    shell_cmd_t **item = shell_cmd_index.item;
+    uint16_t low = 0;
+    uint16_t high = shell_cmd_index.count;
+    uint16_t mid;
+
+    while(low < high) {
+        mid = low + (high - low) / 2;
+        if(shell_cmd_index_compare(item[mid], command) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell cmd index insert
+ * @details    put a runtime record at its sorted position,
+ *             index has room for SHELL_DYNAMIC_MAX of them
+ * -----------------------------------------------
+ * @param[in]  command : shell cmd
+ * -----------------------------------------------
+ */
+static void shell_cmd_index_insert(shell_cmd_t *command)
+{
+    shell_cmd_t **item = shell_cmd_index.item;
+    uint16_t pos = shell_cmd_index_position(command);
+
+    memmove(&item[pos + 1], &item[pos],
+            (shell_cmd_index.count - pos) * sizeof(shell_cmd_t *));
+    item[pos] = command;
+    shell_cmd_index.count++;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell cmd index remove
+ * -----------------------------------------------
+ * @param[in]  command : shell cmd
+ * -----------------------------------------------
+ */
+static void shell_cmd_index_remove(shell_cmd_t *command)
+{
+    shell_cmd_t **item = shell_cmd_index.item;
+    uint16_t pos = shell_cmd_index_position(command);
+
+    if(pos < shell_cmd_index.count && item[pos] == command) {
+        shell_cmd_index.count--;
+        memmove(&item[pos], &item[pos + 1],
+                (shell_cmd_index.count - pos) * sizeof(shell_cmd_t *));
+    }
+}
+#endif /** SHELL_USING_DYNAMIC == 1 */
+#endif /** SHELL_USING_CMD_INDEX == 1 */
+
+#if SHELL_USING_CMD_HASH == 1
+/**
+ * -----------------------------------------------
+ * @brief      shell cmd hash slot
+ * @details    fnv-1a of name, then the displacement of its
+ *             bucket mixed in, same as tools/shell_cmd_hash.py
+ * -----------------------------------------------
+ * @param[in]  name : cmd name
+ * -----------------------------------------------
+ * @return     uint16_t : slot of name
+ * -----------------------------------------------
+ */
+static uint16_t shell_cmd_hash_slot(const char *name)
+{
+    uint32_t hash = 2166136261UL ^ shell_cmd_hash.seed;
+
+    while(*name) {
+        hash ^= (uint8_t)*name++;
+        hash *= 16777619UL;
+    }
+    hash ^= shell_cmd_hash.disp[hash % shell_cmd_hash.bucket_count] * 0x9E3779B9UL;
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6BUL;
+    hash ^= hash >> 13;
+    return hash % shell_cmd_hash.count;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell check cmd hash
+ * @details    use the generated table only if it holds every
+ *             cmd/var/user of section, each at the slot of its
+ *             name, so a section with records of modules the
+ *             table was not generated from falls back
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * -----------------------------------------------
+ */
+static void shell_check_cmd_hash(shell_t *shell)
+{
+    const shell_cmd_t *base = shell->command_list.base;
+    const shell_cmd_t *item;
+
+    shell_cmd_hash_valid = 0;
+    if(&shell_cmd_hash == NULL ||
+       shell_cmd_hash.count != shell->command_list.count ||
+       shell_cmd_hash.bucket_count == 0)
+    {
+        return;
+    }
+    for(uint16_t i = 0; i < shell_cmd_hash.count; i++) {
+        item = shell_cmd_hash.slot[i];
+        if(item < base || item >= base + shell->command_list.count ||
+           shell_cmd_hash_slot(shell_get_command_name((shell_cmd_t *)item)) != i)
+        {
+            return;
+        }
+    }
+    shell_cmd_hash_valid = 1;
+}
+#endif /** SHELL_USING_CMD_HASH == 1 */
+
+/**
+ * -----------------------------------------------
+ * @brief      shell seek cmd
+ * @details    seek shell cmd
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * @param[in]  cmd : shell cmd
+ * @param[in]  base : shell cmd base
+ * @param[in]  compareLength : compare length
+ * -----------------------------------------------
+ * @return     shell_cmd_t* : shell cmd
+ * -----------------------------------------------
+ */
+shell_cmd_t *shell_seek_cmd(shell_t *shell,
+                            const char *cmd,
+                            shell_cmd_t *base,
+                            uint16_t compare_length)
+{
+    shell_cmd_t *list;
+    const char *name;
+    uint16_t count;
+
+#if SHELL_USING_CMD_HASH == 1
+    /*! names are unique in a generated table, one hash & one compare,
+        name leads cmd, var and user alike */
+    if(!compare_length && shell_cmd_hash_valid) {
+        shell_cmd_t *item = (shell_cmd_t *)shell_cmd_hash.slot[shell_cmd_hash_slot(cmd)];
+        if(item >= base && strcmp(cmd, item->data.cmd.name) == 0 &&
+           SHELL_CMD_VISIBLE(shell, item))
+        {
+            return item;
+        }
+        /*! runtime records are not in the table */
+        if(!SHELL_DYNAMIC_CMD_COUNT) {
+            return NULL;
+        }
+    }
+#endif /** SHELL_USING_CMD_HASH == 1 */
+
+#if SHELL_USING_CMD_INDEX == 1
+    if(shell_cmd_index.is_valid) {
+        return shell_seek_cmd_index(shell, cmd, base, compare_length);
+    }
+#endif /** SHELL_USING_CMD_INDEX == 1 */
+
+    list = shell->command_list.base;
+    count = shell->command_list.count;
+    for(uint16_t i = SHELL_NEXT_CMD(shell, (uint16_t)(base - list)); i < count;
+        i = SHELL_NEXT_CMD(shell, i + 1))
+    {
+        /*! section holds cmd, var and user only, name leads each */
+        name = list[i].data.cmd.name;
         if(!compare_length) {
             if(strcmp(cmd, name) == 0) {
-                return &base[i];
+                return &list[i];
             }
         } else {
             if(strncmp(cmd, name, compare_length) == 0) {
-                return &base[i];
+                return &list[i];
             }
         }
     }
+#if SHELL_USING_DYNAMIC == 1
+    for(uint16_t i = 0; i < shell_dynamic.cmd_count; i++) {
+        list = (shell_cmd_t *)shell_dynamic.cmd[i];
+        if(SHELL_CMD_VISIBLE(shell, list) &&
+           (compare_length ? strncmp(cmd, list->data.cmd.name, compare_length)
+                           : strcmp(cmd, list->data.cmd.name)) == 0)
+        {
+            return list;
+        }
+    }
+#endif /** SHELL_USING_DYNAMIC == 1 */
     return NULL;
 }
 
@@ -1194,10 +2148,14 @@ unsigned int shell_run_command(shell_t *shell, shell_cmd_t *command)
 {
     int returnValue = 0;
     shell->status.is_active = 1;
+    /*! command may write to the port directly */
+    shell_write_flush(shell);
     if(command->attr.para.type == SHELL_TYPE_CMD_MAIN) {
         shell_remove_param_quotes(shell);
         int (*func)(int, char **) = command->data.cmd.function;
+        SHELL_STATS_START();
         returnValue = func(shell->parser.param_count, shell->parser.param);
+        SHELL_STATS_STOP(command);
         if(!command->attr.para.disable_return) {
             shell_write_return_value(shell, returnValue);
         }
@@ -1256,6 +2214,9 @@ static void shell_check_password(shell_t *shell)
 static void shell_set_user(shell_t *shell, const shell_cmd_t *user)
 {
     shell->info.sh_cmd = user;
+#if SHELL_USING_VISIBLE_MAP == 1
+    shell_build_visible(shell);
+#endif /** SHELL_USING_VISIBLE_MAP == 1 */
     shell->status.is_checked =
         ((user->data.user.pasd && strlen(user->data.user.pasd) != 0) &&
          (shell->parser.param_count < 2 ||
@@ -1299,464 +2260,2023 @@ static void shell_write_return_value(shell_t *shell, int value)
 }
 
 #if SHELL_HISTORY_MAX_NUMBER > 0
+/*! arena position a + b, wrapped */
+#define SHELL_HISTORY_POS(shell, a, b) \
+    ((uint16_t)(((uint32_t)(a) + (b)) % (shell)->history.size))
+
 /**
  * -----------------------------------------------
- * @brief      shell history add
- * @details    add shell history
+ * @brief      shell history copy
+ * @details    copy between arena and memory across the wrap
  * -----------------------------------------------
- * @param[in]  shell : shell struct
+ * @param[in]  shell  : shell struct
+ * @param[in]  pos    : arena position
+ * @param[io]  data   : memory
+ * @param[in]  length : copy length
+ * @param[in]  store  : {@code 1} memory to arena {@code 0} arena to memory
  * -----------------------------------------------
  */
-static void shell_history_add(shell_t *shell)
+static void shell_history_copy(shell_t *shell, uint16_t pos, char *data,
+                               uint16_t length, uint8_t store)
 {
-    shell->history.offset = 0;
-    if(shell->history.number > 0 &&
-       strcmp(shell->history.item[(shell->history.record ==
-                                   0 ? SHELL_HISTORY_MAX_NUMBER : shell->history
-                                   .record) - 1],
-              shell->parser.buffer) == 0)
-    {
-        return;
-    }
-    if(shell_string_copy(shell->history.item[shell->history.record],
-                         shell->parser.buffer) != 0)
-    {
-        shell->history.record++;
-    }
-    if(++shell->history.number > SHELL_HISTORY_MAX_NUMBER) {
-        shell->history.number = SHELL_HISTORY_MAX_NUMBER;
+    uint16_t first = shell->history.size - pos;
+    char *arena = shell->history.buffer;
+
+    if(first > length) {
+        first = length;
     }
-    if(shell->history.record >= SHELL_HISTORY_MAX_NUMBER) {
-        shell->history.record = 0;
+    if(store) {
+        memcpy(arena + pos, data, first);
+        memcpy(arena, data + first, length - first);
+    } else {
+        memcpy(data, arena + pos, first);
+        memcpy(data + first, arena, length - first);
     }
 }
 
 /**
  * -----------------------------------------------
- * @brief      shell history
- * @details    show shell history
- * -----------------------------------------------
- * @param[in]  shell : shell struct
- * @param[in]  dir   : direction {@code <0} up {@code >0} down
+ * @brief      shell history length
+ * @details    read entry length stored at pos
  * -----------------------------------------------
  */
-static void shell_history(shell_t *shell, signed char dir)
+static uint16_t shell_history_length(shell_t *shell, uint16_t pos)
 {
-    if(dir > 0) {
-        if(shell->history.offset-- <=
-           -((shell->history.number >
-              shell->history.record) ? shell->history.number : shell->history.
-             record))
-        {
-            shell->history.offset =
-                -((shell->history.number > shell->history.record)
-                                          ? shell->history.number
-                                          : shell->history.record);
-        }
-    } else if(dir < 0) {
-        if(++shell->history.offset > 0) {
-            shell->history.offset = 0;
-            return;
-        }
-    } else {
-        return;
-    }
-    shell_clear_command_line(shell);
-    if(shell->history.offset == 0) {
-        shell->parser.cursor = shell->parser.length = 0;
-    } else {
-        if((shell->parser.length = shell_string_copy(shell->parser.buffer,
-                                                     shell->history.item[(shell
-                                                                          ->
-                                                                          history
-                                                                          .
-                                                                          record
-                                                                          +
-                                                                          SHELL_HISTORY_MAX_NUMBER
-                                                                          +
-                                                                          shell
-                                                                          ->
-                                                                          history
-                                                                          .
-                                                                          offset)
-                                                                         %
-                                                                         SHELL_HISTORY_MAX_NUMBER
-                                                     ])) == 0)
-        {
-            return;
-        }
-        shell->parser.cursor = shell->parser.length;
-        shell_write_string(shell, shell->parser.buffer);
-    }
-}
+    uint8_t length[2];
 
-#endif /** SHELL_HISTORY_MAX_NUMBER > 0 */
+    shell_history_copy(shell, pos, (char *)length, 2, 0);
+    return length[0] | (length[1] << 8);
+}
 
+#if SHELL_HISTORY_SEARCH == 1
 /**
  * -----------------------------------------------
- * @brief      shell normal input
- * @details    normal input shell
- * -----------------------------------------------
- * @param[in]  shell : shell struct
- * @param[in]  data  : input byte
+ * @brief      shell history mask
+ * @details    chars of a string folded to 32 bits,
+ *             an entry without all pattern bits cannot match
  * -----------------------------------------------
  */
-void shell_normal_input(shell_t *shell, char data)
+static uint32_t shell_history_mask(const char *data, uint16_t length)
 {
-    shell->status.tab_flag = 0;
-    shell_insert_byte(shell, data);
+    uint32_t mask = 0;
+
+    while(length--) {
+        mask |= 1UL << (*data++ & 0x1F);
+    }
+    return mask;
 }
+#endif /** SHELL_HISTORY_SEARCH == 1 */
 
 /**
  * -----------------------------------------------
- * @brief      shell exec command
- * @details    exec shell command
+ * @brief      shell history push
+ * @details    push one entry, evict oldest ones until it fits
  * -----------------------------------------------
- * @param[in]  shell : shell struct
+ * @param[in]  shell  : shell struct
+ * @param[in]  cmd    : command
+ * @param[in]  length : command length
+ * @return     int    : 1 stored, 0 too long or repeat
  * -----------------------------------------------
  */
-void shell_exec(shell_t *shell)
+static int shell_history_push(shell_t *shell, char *cmd, uint16_t length)
 {
+    uint16_t last;
+    uint8_t size[2] = {length & 0xFF, length >> 8};
 
-    if(shell->parser.length == 0) {
-        return;
+    if(length + 4 > shell->history.size) {
+        return 0;
     }
-
-    shell->parser.buffer[shell->parser.length] = 0;
-
-    if(shell->status.is_checked) {
-#if SHELL_HISTORY_MAX_NUMBER > 0
-        shell_history_add(shell);
-#endif /** SHELL_HISTORY_MAX_NUMBER > 0 */
-        shell_parser_param(shell);
-        shell->parser.length = shell->parser.cursor = 0;
-        if(shell->parser.param_count == 0) {
-            return;
-        }
-        shell_write_string(shell, "\r\n");
-
-        shell_cmd_t *command = shell_seek_cmd(shell,
-                                              shell->parser.param[0],
-                                              shell->command_list.base,
-                                              0);
-        if(command != NULL) {
-            shell_run_command(shell, command);
-        } else {
-            shell_write_string(shell, shell_text[SHELL_TEXT_CMD_NOT_FOUND]);
+    if(shell->history.number > 0) {
+        /*! skip repeat of the newest entry */
+        last = shell_history_length(shell,
+                                    SHELL_HISTORY_POS(shell, shell->history.head,
+                                                      shell->history.size - 2));
+        if(last == length) {
+            uint16_t pos = SHELL_HISTORY_POS(shell, shell->history.head,
+                                             shell->history.size - length - 2);
+            uint16_t first = shell->history.size - pos;
+            first = (first > length) ? length : first;
+            if(memcmp(shell->history.buffer + pos, cmd, first) == 0 &&
+               memcmp(shell->history.buffer, cmd + first, length - first) == 0)
+            {
+                return 0;
+            }
         }
-    } else {
-        shell_check_password(shell);
     }
+    while(shell->history.number >= SHELL_HISTORY_MAX_NUMBER ||
+          shell->history.used + length + 4 > shell->history.size)
+    {
+        last = shell_history_length(shell, shell->history.tail) + 4;
+        shell->history.tail = SHELL_HISTORY_POS(shell, shell->history.tail, last);
+        shell->history.used -= last;
+        shell->history.number--;
+#if SHELL_HISTORY_SEARCH == 1
+        shell->history.first = (shell->history.first + 1) % SHELL_HISTORY_MAX_NUMBER;
+#endif /** SHELL_HISTORY_SEARCH == 1 */
+    }
+#if SHELL_HISTORY_SEARCH == 1
+    last = (shell->history.first + shell->history.number) % SHELL_HISTORY_MAX_NUMBER;
+    shell->history.index[last].pos = shell->history.head;
+    shell->history.index[last].mask = shell_history_mask(cmd, length);
+#endif /** SHELL_HISTORY_SEARCH == 1 */
+    shell_history_copy(shell, shell->history.head, (char *)size, 2, 1);
+    shell_history_copy(shell, SHELL_HISTORY_POS(shell, shell->history.head, 2),
+                       cmd, length, 1);
+    shell_history_copy(shell, SHELL_HISTORY_POS(shell, shell->history.head, length + 2),
+                       (char *)size, 2, 1);
+    shell->history.head = SHELL_HISTORY_POS(shell, shell->history.head, length + 4);
+    shell->history.used += length + 4;
+    shell->history.number++;
+    return 1;
 }
 
-#if SHELL_HISTORY_MAX_NUMBER > 0
+#if SHELL_HISTORY_PERSIST == 1
+/*! log is `magic | record...`, record is `length(2) | check | cmd` */
+#define SHELL_HISTORY_LOG_MAGIC     "SHH1"
+#define SHELL_HISTORY_LOG_HEAD      4
+#define SHELL_HISTORY_LOG_RECORD    3
+
 /**
  * -----------------------------------------------
- * @brief      shell up direction key input
- * @details    up direction key input shell
- * -----------------------------------------------
- * @param[in]  shell : shell struct
+ * @brief      shell history log check
+ * @details    8 bit sum, record check is ~sum of length and cmd
  * -----------------------------------------------
  */
-void shell_up(shell_t *shell)
+static uint8_t shell_history_log_sum(const char *data, uint16_t length, uint8_t sum)
 {
-    shell_history(shell, 1);
+    while(length--) {
+        sum += (uint8_t)*data++;
+    }
+    return sum;
 }
 
-SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0), 0x1B5B4100, shell_up, up);
-
 /**
  * -----------------------------------------------
- * @brief      shell down direction key input
- * @details    down direction key input shell
+ * @brief      shell history log put
+ * @details    append one record, cmd may be split in two parts,
+ *             the end mark after it is written first and the
+ *             head last, a torn write ends the log before it
+ * -----------------------------------------------
+ * @param[in]  shell  : shell struct
+ * @param[in]  data   : cmd first part
+ * @param[in]  first  : first part length
+ * @param[in]  rest   : cmd second part
+ * @param[in]  second : second part length
+ * @return     int    : 0 success, -1 log full or write fail
+ * -----------------------------------------------
+ */
+static int shell_history_log_put(shell_t *shell, const char *data, uint16_t first,
+                                 const char *rest, uint16_t second)
+{
+    static const char end[SHELL_HISTORY_LOG_RECORD] = {0};
+    uint16_t length = first + second;
+    uint32_t offset = shell->history.log;
+    uint32_t next = offset + SHELL_HISTORY_LOG_RECORD + length;
+    char head[SHELL_HISTORY_LOG_RECORD] = {length & 0xFF, length >> 8, 0};
+
+    if(next > SHELL_HISTORY_LOG_SIZE) {
+        return -1;
+    }
+    head[2] = ~shell_history_log_sum(rest, second,
+                                     shell_history_log_sum(data, first,
+                                                           head[0] + head[1]));
+    if((next + SHELL_HISTORY_LOG_RECORD <= SHELL_HISTORY_LOG_SIZE &&
+        shell->history_write(next, end, SHELL_HISTORY_LOG_RECORD) !=
+        SHELL_HISTORY_LOG_RECORD) ||
+       shell->history_write(offset + SHELL_HISTORY_LOG_RECORD, data, first) != first ||
+       (second && shell->history_write(offset + SHELL_HISTORY_LOG_RECORD + first,
+                                       rest, second) != second) ||
+       shell->history_write(offset, head, SHELL_HISTORY_LOG_RECORD) !=
+       SHELL_HISTORY_LOG_RECORD)
+    {
+        return -1;
+    }
+    shell->history.log = next;
+    return 0;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell history log compact
+ * @details    start the log over with the newest entries held
+ *             in arena that fit in it
  * -----------------------------------------------
  * @param[in]  shell : shell struct
  * -----------------------------------------------
  */
-void shell_down(shell_t *shell)
+static void shell_history_log_compact(shell_t *shell)
 {
-    shell_history(shell, -1);
+    uint32_t size = SHELL_HISTORY_LOG_HEAD;
+    uint16_t pos = shell->history.tail;
+    uint16_t skip = 0;
+    uint16_t length;
+    uint16_t text;
+    uint16_t first;
+
+    /*! drop the oldest entries the log can not hold */
+    for(uint16_t i = 0; i < shell->history.number; i++) {
+        length = shell_history_length(shell, pos);
+        size += SHELL_HISTORY_LOG_RECORD + length;
+        pos = SHELL_HISTORY_POS(shell, pos, length + 4);
+    }
+    pos = shell->history.tail;
+    while(size > SHELL_HISTORY_LOG_SIZE) {
+        length = shell_history_length(shell, pos);
+        size -= SHELL_HISTORY_LOG_RECORD + length;
+        pos = SHELL_HISTORY_POS(shell, pos, length + 4);
+        skip++;
+    }
+
+    shell->history.log = 0;
+    if(shell->history_write(0, SHELL_HISTORY_LOG_MAGIC, SHELL_HISTORY_LOG_HEAD) !=
+       SHELL_HISTORY_LOG_HEAD)
+    {
+        return;
+    }
+    shell->history.log = SHELL_HISTORY_LOG_HEAD;
+    for(uint16_t i = skip; i < shell->history.number; i++) {
+        length = shell_history_length(shell, pos);
+        text = SHELL_HISTORY_POS(shell, pos, 2);
+        first = shell->history.size - text;
+        first = (first > length) ? length : first;
+        if(shell_history_log_put(shell, shell->history.buffer + text, first,
+                                 shell->history.buffer, length - first) != 0)
+        {
+            return;
+        }
+        pos = SHELL_HISTORY_POS(shell, pos, length + 4);
+    }
 }
 
-SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0), 0x1B5B4200, shell_down, down);
-#endif /** SHELL_HISTORY_MAX_NUMBER > 0 */
+/**
+ * -----------------------------------------------
+ * @brief      shell history log load
+ * @details    replay log into arena, stop at the first bad
+ *             record and append from there
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * -----------------------------------------------
+ */
+static void shell_history_log_load(shell_t *shell)
+{
+    uint32_t offset = SHELL_HISTORY_LOG_HEAD;
+    char magic[SHELL_HISTORY_LOG_HEAD];
+    char head[SHELL_HISTORY_LOG_RECORD];
+    char *buffer = shell->parser.buffer;
+    uint16_t length;
+
+    shell->history.log = 0;
+    if(!shell->history_read || !shell->history_write ||
+       shell->history_read(0, magic, SHELL_HISTORY_LOG_HEAD) != SHELL_HISTORY_LOG_HEAD ||
+       memcmp(magic, SHELL_HISTORY_LOG_MAGIC, SHELL_HISTORY_LOG_HEAD) != 0)
+    {
+        return;
+    }
+    /*! check is ~sum, so sum + check is 0xFF for a good record */
+    while(offset + SHELL_HISTORY_LOG_RECORD <= SHELL_HISTORY_LOG_SIZE &&
+          shell->history_read(offset, head, SHELL_HISTORY_LOG_RECORD) ==
+          SHELL_HISTORY_LOG_RECORD)
+    {
+        length = (uint8_t)head[0] | ((uint8_t)head[1] << 8);
+        if(length == 0 || length >= shell->parser.buffer_size ||
+           shell->history_read(offset + SHELL_HISTORY_LOG_RECORD,
+                               buffer, length) != (int)length ||
+           (uint8_t)(shell_history_log_sum(buffer, length, head[0] + head[1]) +
+                     (uint8_t)head[2]) != 0xFF)
+        {
+            break;
+        }
+        shell_history_push(shell, buffer, length);
+        offset += SHELL_HISTORY_LOG_RECORD + length;
+    }
+    shell->history.log = offset;
+}
+#endif /** SHELL_HISTORY_PERSIST == 1 */
 
 /**
  * -----------------------------------------------
- * @brief      shell right direction key input
- * @details    right direction key input shell
+ * @brief      shell history add
+ * @details    add line to history, then append it to log
  * -----------------------------------------------
  * @param[in]  shell : shell struct
  * -----------------------------------------------
  */
-void shell_right(shell_t *shell)
+static void shell_history_add(shell_t *shell)
 {
-    if(shell->parser.cursor < shell->parser.length) {
-        shell_write_byte(shell, shell->parser.buffer[shell->parser.cursor++]);
+    shell->history.offset = 0;
+    if(!shell_history_push(shell, shell->parser.buffer, shell->parser.length)) {
+        return;
+    }
+#if SHELL_HISTORY_PERSIST == 1
+    if(shell->history_write &&
+       (shell->history.log == 0 ||
+        shell_history_log_put(shell, shell->parser.buffer, shell->parser.length,
+                              NULL, 0) != 0))
+    {
+        shell_history_log_compact(shell);
     }
+#endif /** SHELL_HISTORY_PERSIST == 1 */
 }
 
-SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0) | SHELL_CMD_ENABLE_UNCHECKED,
-                 0x1B5B4300, shell_right, right);
+/**
+ * -----------------------------------------------
+ * @brief      shell history
+ * @details    show shell history, one step over the ring
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * @param[in]  dir   : direction {@code <0} up {@code >0} down
+ * -----------------------------------------------
+ */
+static void shell_history(shell_t *shell, signed char dir)
+{
+    uint16_t length;
+
+    if(dir > 0) {
+        if(shell->history.offset >= shell->history.number) {
+            return;
+        }
+        /*! older entry ends right before the shown one */
+        shell->history.record = shell->history.offset++ ? shell->history.record
+                                                        : shell->history.head;
+        length = shell_history_length(shell,
+                                      SHELL_HISTORY_POS(shell, shell->history.record,
+                                                        shell->history.size - 2));
+        shell->history.record = SHELL_HISTORY_POS(shell, shell->history.record,
+                                                  shell->history.size - length - 4);
+    } else if(dir < 0) {
+        if(shell->history.offset == 0) {
+            return;
+        }
+        if(--shell->history.offset) {
+            length = shell_history_length(shell, shell->history.record);
+            shell->history.record = SHELL_HISTORY_POS(shell, shell->history.record,
+                                                      length + 4);
+        }
+    } else {
+        return;
+    }
+    shell_clear_command_line(shell);
+    shell->parser.cursor = shell->parser.length = 0;
+    if(shell->history.offset != 0) {
+        length = shell_history_length(shell, shell->history.record);
+        if(length > shell->parser.buffer_size - 1) {
+            length = shell->parser.buffer_size - 1;
+        }
+        shell_history_copy(shell, SHELL_HISTORY_POS(shell, shell->history.record, 2),
+                           shell->parser.buffer, length, 0);
+        shell->parser.cursor = shell->parser.length = length;
+        shell_write_line(shell);
+    }
+}
 
+#if SHELL_HISTORY_SEARCH == 1
 /**
  * -----------------------------------------------
- * @brief      shell left direction key input
- * @details    left direction key input shell
+ * @brief      shell history contains
+ * @details    whether entry at pos contains the search pattern
+ * -----------------------------------------------
+ */
+static int shell_history_contains(shell_t *shell, uint16_t pos)
+{
+    uint16_t length = shell_history_length(shell, pos);
+    uint16_t j;
+
+    pos = SHELL_HISTORY_POS(shell, pos, 2);
+    for(uint16_t i = 0; i + shell->history.pattern_length <= length; i++) {
+        for(j = 0; j < shell->history.pattern_length; j++) {
+            if(shell->history.buffer[SHELL_HISTORY_POS(shell, pos, i + j)] !=
+               shell->history.pattern[j])
+            {
+                break;
+            }
+        }
+        if(j == shell->history.pattern_length) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell history find
+ * @details    newest entry from age on containing the pattern,
+ *             the mask index skips most entries without a scan
  * -----------------------------------------------
  * @param[in]  shell : shell struct
+ * @param[in]  age   : first entry age to check, 1 for newest
+ * @return     matched entry age, 0 if none
  * -----------------------------------------------
  */
-void shell_left(shell_t *shell)
+static uint16_t shell_history_find(shell_t *shell, uint16_t age)
 {
-    if(shell->parser.cursor > 0) {
-        shell_write_byte(shell, '\b');
-        shell->parser.cursor--;
+    uint32_t mask = shell_history_mask(shell->history.pattern,
+                                       shell->history.pattern_length);
+    uint16_t slot;
+
+    for(; age <= shell->history.number; age++) {
+        slot = (shell->history.first + shell->history.number - age) %
+               SHELL_HISTORY_MAX_NUMBER;
+        if((shell->history.index[slot].mask & mask) == mask &&
+           shell_history_contains(shell, shell->history.index[slot].pos))
+        {
+            return age;
+        }
     }
+    return 0;
 }
 
-SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0) | SHELL_CMD_ENABLE_UNCHECKED,
-                 0x1B5B4400, shell_left, left);
+/**
+ * -----------------------------------------------
+ * @brief      shell history search draw
+ * @details    redraw from the end of pattern to the end of
+ *             line, cursor back to the end of pattern
+ * -----------------------------------------------
+ */
+static void shell_history_search_draw(shell_t *shell)
+{
+    uint16_t length = 0;
+    uint16_t pos;
+    uint16_t first;
+
+    shell_write_string(shell, "': ");
+    if(shell->history.match) {
+        pos = shell->history.index[(shell->history.first + shell->history.number -
+                                    shell->history.match) %
+                                   SHELL_HISTORY_MAX_NUMBER].pos;
+        length = shell_history_length(shell, pos);
+        pos = SHELL_HISTORY_POS(shell, pos, 2);
+        first = shell->history.size - pos;
+        first = (first > length) ? length : first;
+        shell_write_data(shell, shell->history.buffer + pos, first);
+        if(length > first) {
+            shell_write_data(shell, shell->history.buffer, length - first);
+        }
+    }
+    shell_write_string(shell, "\033[K");
+    shell_write_cursor(shell, length + 3, 'D');
+}
 
 /**
  * -----------------------------------------------
- * @brief      shell tab key input
- * @details    tab key input shell
+ * @brief      shell history search end
+ * @details    leave search, matched entry becomes the line
  * -----------------------------------------------
  * @param[in]  shell : shell struct
  * -----------------------------------------------
  */
-void shell_tab(shell_t *shell)
+static void shell_history_search_end(shell_t *shell)
 {
-    uint16_t maxMatch = shell->parser.buffer_size;
-    uint16_t lastMatchIndex = 0;
-    uint16_t matchNum = 0;
+    uint16_t pos;
     uint16_t length;
 
-    if(shell->parser.length == 0) {
-        shell_list_all(shell);
-        shell_write_prompt(shell, 1);
-    } else if(shell->parser.length > 0) {
-        shell->parser.buffer[shell->parser.length] = 0;
-        shell_cmd_t *base = (shell_cmd_t *)shell->command_list.base;
-        for(short i = 0; i < shell->command_list.count; i++) {
-            if(shell_check_permission(shell,
-                                      &base[i]) == 0 &&
-               shell_string_compare(shell->parser.buffer,
-                                    (
-                                        char
-                                        *)shell_get_command_name(&base[i])) ==
-               shell->parser.length)
-            {
-                if(matchNum != 0) {
-                    if(matchNum == 1) {
-                        shell_write_string(shell, "\r\n");
-                    }
-                    shell_list_item(shell, &base[lastMatchIndex]);
-                    length =
-                        shell_string_compare((char *)shell_get_command_name(&
-                                                                            base
-                                                                            [
-                                                                                lastMatchIndex
-                                                                            ]),
-                                             (char *)shell_get_command_name(&
-                                                                            base
-                                                                            [i]));
-                    maxMatch = (maxMatch > length) ? length : maxMatch;
-                }
-                lastMatchIndex = i;
-                matchNum++;
-            }
+    shell->history.search = 0;
+    if(shell->history.match) {
+        pos = shell->history.index[(shell->history.first + shell->history.number -
+                                    shell->history.match) %
+                                   SHELL_HISTORY_MAX_NUMBER].pos;
+        length = shell_history_length(shell, pos);
+        if(length > shell->parser.buffer_size - 1) {
+            length = shell->parser.buffer_size - 1;
         }
-        if(matchNum == 0) {
+        shell_history_copy(shell, SHELL_HISTORY_POS(shell, pos, 2),
+                           shell->parser.buffer, length, 0);
+        shell->parser.cursor = shell->parser.length = length;
+    }
+    shell_write_string(shell, shell_text[SHELL_TEXT_CLEAR_LINE]);
+    shell_write_prompt(shell, 0);
+    shell_write_line(shell);
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell history search input
+ * @details    edit search pattern, only the changed part
+ *             of the line is written
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * @param[in]  data  : input byte, '\b' to erase
+ * -----------------------------------------------
+ */
+static void shell_history_search_input(shell_t *shell, char data)
+{
+    uint16_t match;
+
+    if(data == '\b') {
+        if(shell->history.pattern_length == 0) {
             return;
         }
-        if(matchNum == 1) {
-            shell_clear_command_line(shell);
+        shell->history.pattern_length--;
+        shell_write_string(shell, "\b\033[P");
+        match = shell_history_find(shell, 1);
+    } else {
+        if(data < ' ' ||
+           shell->history.pattern_length >= SHELL_HISTORY_SEARCH_LENGTH)
+        {
+            return;
         }
-        if(matchNum != 0) {
-            shell->parser.length =
-                shell_string_copy(shell->parser.buffer,
-                                  (char *)shell_get_command_name(&base[
-                                                                     lastMatchIndex
-                                                                 ]));
+        shell->history.pattern[shell->history.pattern_length++] = data;
+        match = shell_history_find(shell, shell->history.match ?
+                                          shell->history.match : 1);
+        if(match == 0 || match == shell->history.match) {
+            /*! same line shown, only open a cell for the byte */
+            shell_write_string(shell, "\033[@");
         }
-        if(matchNum > 1) {
-            shell_list_item(shell, &base[lastMatchIndex]);
-            shell_write_prompt(shell, 1);
-            shell->parser.length = maxMatch;
+        shell_write_byte(shell, data);
+    }
+    if(match != 0 && match != shell->history.match) {
+        shell->history.match = match;
+        shell_history_search_draw(shell);
+    }
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell history search key input
+ * @details    start reverse search, or step to an older match
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * -----------------------------------------------
+ */
+void shell_history_search(shell_t *shell)
+{
+    uint16_t match;
+
+    if(!shell->history.search) {
+        shell_clear_command_line(shell);
+        shell->history.search = 1;
+        shell->history.pattern_length = 0;
+        shell->history.match = 0;
+        shell_write_string(shell, "(reverse-i-search)'");
+        shell_history_search_draw(shell);
+    } else if(shell->history.pattern_length) {
+        match = shell_history_find(shell, shell->history.match + 1);
+        if(match) {
+            shell->history.match = match;
+            shell_history_search_draw(shell);
         }
-        shell->parser.buffer[shell->parser.length] = 0;
-        shell->parser.cursor = shell->parser.length;
-        shell_write_string(shell, shell->parser.buffer);
     }
+}
 
-    if(SHELL_GET_TICK()) {
-        if(matchNum == 1 && shell->status.tab_flag &&
-           SHELL_GET_TICK() - shell->info.active_time < SHELL_DOUBLE_CLICK_TIME)
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0), 0x12000000, shell_history_search, reverse search);
+#endif /** SHELL_HISTORY_SEARCH == 1 */
+
+#endif /** SHELL_HISTORY_MAX_NUMBER > 0 */
+
+/**
+ * -----------------------------------------------
+ * @brief      shell normal input
+ * @details    normal input shell
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * @param[in]  data  : input byte
+ * -----------------------------------------------
+ */
+void shell_normal_input(shell_t *shell, char data)
+{
+    shell->status.tab_flag = 0;
+#if SHELL_HISTORY_MAX_NUMBER > 0 && SHELL_HISTORY_SEARCH == 1
+    if(shell->history.search) {
+        shell_history_search_input(shell, data);
+        return;
+    }
+#endif
+    shell_insert_byte(shell, data);
+}
+
+#if SHELL_SUPPORT_CMD_SEQUENCE == 1
+/**
+ * -----------------------------------------------
+ * @brief      shell split cmd sequence
+ * @details    find the first `;` or `&&` out of quotes,
+ *             brackets and braces, and terminate the cmd
+ *             before it
+ * -----------------------------------------------
+ * @param[in]  string : cmd sequence
+ * @param[in]  end    : cmd sequence end
+ * @param[out] next   : next cmd
+ * @param[out] op     : `;` or `&` before next cmd, 0 if last
+ * -----------------------------------------------
+ * @return     uint16_t : cmd length
+ * -----------------------------------------------
+ */
+static uint16_t shell_split_sequence(char *string, char *end, char **next, char *op)
+{
+    static const char pairs[][2] = {
+        { '\"', '\"' },
+        { '[', ']' },
+        { '(', ')' },
+        { '{', '}' },
+    };
+    char left[16];
+    uint8_t depth = 0;
+
+    for(char *p = string; p < end; p++) {
+        if(*p == '\\' && p + 1 < end) {
+            p++;
+            continue;
+        }
+        if(depth == 0 &&
+           (*p == ';' || (*p == '&' && p + 1 < end && p[1] == '&')))
         {
-#if SHELL_QUICK_HELP == 1
-            shell_write_string(shell, "\r\n");
-            shell_write_cmd_help(shell, shell->parser.buffer);
-            shell_write_prompt(shell, 1);
-            shell_write_string(shell, shell->parser.buffer);
-#else
-            shell_clear_command_line(shell);
-            for(short i = shell->parser.length; i >= 0; i--) {
-                shell->parser.buffer[i + 5] = shell->parser.buffer[i];
+            *op = *p;
+            *p = 0;
+            *next = (*op == '&') ? p + 2 : p + 1;
+            return p - string;
+        }
+        if(depth > 0 && left[depth - 1] == '\"') {
+            /*! nothing nests in quotes */
+            depth -= (*p == '\"');
+            continue;
+        }
+        for(uint8_t j = 0; j < sizeof(pairs) / 2; j++) {
+            if(depth > 0 && *p == pairs[j][1] && left[depth - 1] == pairs[j][0]) {
+                depth--;
+                break;
+            } else if(*p == pairs[j][0] && depth < sizeof(left)) {
+                left[depth++] = *p;
+                break;
             }
-            shell_string_copy(shell->parser.buffer, "help");
-            shell->parser.buffer[4] = ' ';
-            shell->parser.length += 5;
-            shell->parser.cursor = shell->parser.length;
-            shell_write_string(shell, shell->parser.buffer);
-#endif
+        }
+    }
+    *op = 0;
+    *next = end;
+    return end - string;
+}
+#endif /** SHELL_SUPPORT_CMD_SEQUENCE == 1 */
+
+/**
+ * -----------------------------------------------
+ * @brief      shell exec cmd sequence
+ * @details    run cmds of `a; b && c` back to back, cmd
+ *             after `&&` is skipped if the one before
+ *             failed or was skipped
+ * -----------------------------------------------
+ * @param[in]  shell  : shell struct
+ * @param[in]  string : cmd sequence, modified
+ * @param[in]  length : cmd sequence length
+ * @param[in]  newline: write newline before the first cmd
+ * -----------------------------------------------
+ * @return     int : return value of the last cmd run
+ * -----------------------------------------------
+ */
+static int shell_exec_sequence(shell_t *shell, char *string, uint16_t length,
+                               uint8_t newline)
+{
+    char *end = string + length;
+    char *next = end;
+    char op = 0;
+    uint8_t skip = 0;
+    int ret = 0;
+
+    while(string < end) {
+#if SHELL_SUPPORT_CMD_SEQUENCE == 1
+        length = shell_split_sequence(string, end, &next, &op);
+#endif /** SHELL_SUPPORT_CMD_SEQUENCE == 1 */
+        if(!skip) {
+            shell->parser.param_count =
+                shell_split(string, length, shell->parser.param, ' ',
+                            SHELL_PARAMETER_MAX_NUMBER);
+        }
+        if(!skip && shell->parser.param_count) {
+            if(newline) {
+                shell_write_string(shell, "\r\n");
+                newline = 0;
+            }
+            shell_cmd_t *command = shell_seek_cmd(shell,
+                                                  shell->parser.param[0],
+                                                  shell->command_list.base,
+                                                  0);
+            if(command != NULL) {
+                ret = (int)shell_run_command(shell, command);
+            } else {
+                shell_write_string(shell, shell_text[SHELL_TEXT_CMD_NOT_FOUND]);
+                ret = -1;
+            }
+        }
+        if(op == '&') {
+            skip = skip || ret != 0;
         } else {
-            shell->status.tab_flag = 1;
+            skip = 0;
         }
+        string = next;
     }
+    return ret;
 }
 
-SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0), 0x09000000, shell_tab, tab);
+/**
+ * -----------------------------------------------
+ * @brief      shell exec command
+ * @details    exec shell command
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * -----------------------------------------------
+ */
+void shell_exec(shell_t *shell)
+{
+    uint16_t length = shell->parser.length;
+
+    if(length == 0) {
+        return;
+    }
+
+    shell_line_join(shell);
+
+    if(shell->status.is_checked) {
+#if SHELL_HISTORY_MAX_NUMBER > 0
+        shell_history_add(shell);
+#endif /** SHELL_HISTORY_MAX_NUMBER > 0 */
+        shell->parser.length = shell->parser.cursor = 0;
+        shell_exec_sequence(shell, shell->parser.buffer, length, 1);
+    } else {
+        shell_check_password(shell);
+    }
+}
+
+#if SHELL_HISTORY_MAX_NUMBER > 0
+/**
+ * -----------------------------------------------
+ * @brief      shell up direction key input
+ * @details    up direction key input shell
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * -----------------------------------------------
+ */
+void shell_up(shell_t *shell)
+{
+    shell_history(shell, 1);
+}
+
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0), 0x1B5B4100, shell_up, up);
+
+/**
+ * -----------------------------------------------
+ * @brief      shell down direction key input
+ * @details    down direction key input shell
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * -----------------------------------------------
+ */
+void shell_down(shell_t *shell)
+{
+    shell_history(shell, -1);
+}
+
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0), 0x1B5B4200, shell_down, down);
+#endif /** SHELL_HISTORY_MAX_NUMBER > 0 */
+
+/**
+ * -----------------------------------------------
+ * @brief      shell right direction key input
+ * @details    right direction key input shell
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * -----------------------------------------------
+ */
+void shell_right(shell_t *shell)
+{
+    char data;
+
+    if(shell->parser.cursor < shell->parser.length) {
+        data = *SHELL_LINE_TAIL_PTR(shell);
+        shell->parser.buffer[shell->parser.cursor++] = data;
+        shell_write_byte(shell, data);
+    }
+}
+
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0) | SHELL_CMD_ENABLE_UNCHECKED,
+                 0x1B5B4300, shell_right, right);
+
+/**
+ * -----------------------------------------------
+ * @brief      shell left direction key input
+ * @details    left direction key input shell
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * -----------------------------------------------
+ */
+void shell_left(shell_t *shell)
+{
+    if(shell->parser.cursor > 0) {
+        shell_write_byte(shell, '\b');
+        shell->parser.cursor--;
+        *SHELL_LINE_TAIL_PTR(shell) = shell->parser.buffer[shell->parser.cursor];
+    }
+}
+
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0) | SHELL_CMD_ENABLE_UNCHECKED,
+                 0x1B5B4400, shell_left, left);
+
+/**
+ * -----------------------------------------------
+ * @brief      shell tab match
+ * @details    handle one completion candidate,
+ *             list previous match and shrink common prefix
+ * -----------------------------------------------
+ * @param[in]  shell     : shell struct
+ * @param[in]  item      : matched item
+ * @param[io]  last      : last matched item
+ * @param[io]  match_num : matched item number
+ * @param[io]  max_match : common prefix length of matched items
+ * -----------------------------------------------
+ */
+static void shell_tab_match(shell_t *shell, shell_cmd_t *item,
+                            shell_cmd_t **last, uint16_t *match_num,
+                            uint16_t *max_match)
+{
+    uint16_t length;
+
+    if(*match_num != 0) {
+        if(*match_num == 1) {
+            shell_write_string(shell, "\r\n");
+        }
+        shell_list_item(shell, *last);
+        length = shell_string_compare((char *)(*last)->data.cmd.name,
+                                      (char *)item->data.cmd.name);
+        *max_match = (*max_match > length) ? length : *max_match;
+    }
+    *last = item;
+    (*match_num)++;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell tab key input
+ * @details    tab key input shell
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * -----------------------------------------------
+ */
+void shell_tab(shell_t *shell)
+{
+    uint16_t maxMatch = shell->parser.buffer_size;
+    shell_cmd_t *lastMatch = NULL;
+    uint16_t matchNum = 0;
+
+    if(shell->parser.length == 0) {
+        shell_list_all(shell);
+        shell_write_prompt(shell, 1);
+    } else if(shell->parser.length > 0) {
+        shell_write_cursor(shell, SHELL_LINE_TAIL(shell), 'C');
+        shell_line_join(shell);
+#if SHELL_USING_CMD_INDEX == 1
+        if(shell_cmd_index.is_valid) {
+            /*! only walk the sorted range sharing the typed prefix */
+            shell_cmd_t **item = shell_cmd_index.item;
+            for(uint16_t i = shell_cmd_index_lower(shell->parser.buffer,
+                                                   shell->parser.length);
+                i < shell_cmd_index.count &&
+                strncmp(item[i]->data.cmd.name, shell->parser.buffer,
+                        shell->parser.length) == 0;
+                i++)
+            {
+                if(SHELL_CMD_VISIBLE(shell, item[i])) {
+                    shell_tab_match(shell, item[i], &lastMatch,
+                                    &matchNum, &maxMatch);
+                }
+            }
+        } else
+#endif /** SHELL_USING_CMD_INDEX == 1 */
+        {
+            shell_cmd_t *base = (shell_cmd_t *)shell->command_list.base;
+            for(uint16_t i = SHELL_NEXT_CMD(shell, 0); i < shell->command_list.count;
+                i = SHELL_NEXT_CMD(shell, i + 1))
+            {
+                if(shell_string_compare(shell->parser.buffer,
+                                        (char *)base[i].data.cmd.name) ==
+                   shell->parser.length)
+                {
+                    shell_tab_match(shell, &base[i], &lastMatch,
+                                    &matchNum, &maxMatch);
+                }
+            }
+#if SHELL_USING_DYNAMIC == 1
+            for(uint16_t i = 0; i < shell_dynamic.cmd_count; i++) {
+                base = (shell_cmd_t *)shell_dynamic.cmd[i];
+                if(SHELL_CMD_VISIBLE(shell, base) &&
+                   shell_string_compare(shell->parser.buffer,
+                                        (char *)base->data.cmd.name) ==
+                   shell->parser.length)
+                {
+                    shell_tab_match(shell, base, &lastMatch,
+                                    &matchNum, &maxMatch);
+                }
+            }
+#endif /** SHELL_USING_DYNAMIC == 1 */
+        }
+        if(matchNum == 0) {
+            return;
+        }
+        if(matchNum == 1) {
+            shell_clear_command_line(shell);
+        }
+        shell->parser.length =
+            shell_string_copy(shell->parser.buffer,
+                              (char *)lastMatch->data.cmd.name);
+        if(matchNum > 1) {
+            shell_list_item(shell, lastMatch);
+            shell_write_prompt(shell, 1);
+            shell->parser.length = maxMatch;
+        }
+        shell->parser.buffer[shell->parser.length] = 0;
+        shell->parser.cursor = shell->parser.length;
+        shell_write_string(shell, shell->parser.buffer);
+    }
+
+    if(SHELL_GET_TICK()) {
+        if(matchNum == 1 && shell->status.tab_flag &&
+           SHELL_GET_TICK() - shell->info.active_time < SHELL_DOUBLE_CLICK_TIME)
+        {
+#if SHELL_QUICK_HELP == 1
+            shell_write_string(shell, "\r\n");
+            shell_write_cmd_help(shell, shell->parser.buffer);
+            shell_write_prompt(shell, 1);
+            shell_write_string(shell, shell->parser.buffer);
+#else
+            shell_clear_command_line(shell);
+            for(short i = shell->parser.length; i >= 0; i--) {
+                shell->parser.buffer[i + 5] = shell->parser.buffer[i];
+            }
+            shell_string_copy(shell->parser.buffer, "help");
+            shell->parser.buffer[4] = ' ';
+            shell->parser.length += 5;
+            shell->parser.cursor = shell->parser.length;
+            shell_write_string(shell, shell->parser.buffer);
+#endif
+        } else {
+            shell->status.tab_flag = 1;
+        }
+    }
+}
+
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0), 0x09000000, shell_tab, tab);
+
+/**
+ * -----------------------------------------------
+ * @brief      shell backspace key input
+ * @details    backspace key input shell
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * -----------------------------------------------
+ */
+void shell_backspace(shell_t *shell)
+{
+#if SHELL_HISTORY_MAX_NUMBER > 0 && SHELL_HISTORY_SEARCH == 1
+    if(shell->history.search) {
+        shell_history_search_input(shell, '\b');
+        return;
+    }
+#endif
+    shell_delete_byte(shell, 1);
+}
+
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0) | SHELL_CMD_ENABLE_UNCHECKED,
+                 0x08000000, shell_backspace, backspace);
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0) | SHELL_CMD_ENABLE_UNCHECKED,
+                 0x7F000000, shell_backspace, backspace);
+
+/**
+ * -----------------------------------------------
+ * @brief      shell delete key input
+ * @details    delete key input shell
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * -----------------------------------------------
+ */
+void shell_delete(shell_t *shell)
+{
+    shell_delete_byte(shell, -1);
+}
+
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0) | SHELL_CMD_ENABLE_UNCHECKED,
+                 0x1B5B337E, shell_delete, delete);
+
+/**
+ * -----------------------------------------------
+ * @brief      shell enter key input
+ * @details    enter key input shell
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * -----------------------------------------------
+ */
+void shell_enter(shell_t *shell)
+{
+#if SHELL_HISTORY_MAX_NUMBER > 0 && SHELL_HISTORY_SEARCH == 1
+    if(shell->history.search) {
+        shell_history_search_end(shell);
+    }
+#endif
+    shell_exec(shell);
+    shell_write_prompt(shell, 1);
+}
+
+#if SHELL_ENTER_LF == 1
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0) | SHELL_CMD_ENABLE_UNCHECKED,
+                 0x0A000000, shell_enter, enter);
+#endif
+#if SHELL_ENTER_CR == 1
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0) | SHELL_CMD_ENABLE_UNCHECKED,
+                 0x0D000000, shell_enter, enter);
+#endif
+#if SHELL_ENTER_CRLF == 1
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0) | SHELL_CMD_ENABLE_UNCHECKED,
+                 0x0D0A0000, shell_enter, enter);
+#endif
+
+/**
+ * -----------------------------------------------
+ * @brief      shell write command help
+ * @details    write command help shell
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * @param[in]  cmd   : command string
+ * -----------------------------------------------
+ */
+static void shell_write_cmd_help(shell_t *shell, char *cmd)
+{
+    shell_cmd_t *command = shell_seek_cmd(shell,
+                                          cmd,
+                                          shell->command_list.base,
+                                          0);
+    if(command) {
+        shell_write_string(shell, shell_text[SHELL_TEXT_HELP_HEADER]);
+        shell_write_string(shell, shell_get_command_name(command));
+        shell_write_string(shell, "\r\n");
+        shell_write_string(shell, shell_get_command_desc(command));
+        shell_write_string(shell, "\r\n");
+    } else {
+        shell_write_string(shell, shell_text[SHELL_TEXT_CMD_NOT_FOUND]);
+    }
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell help command
+ * @details    show command help shell
+ * -----------------------------------------------
+ * @param[in]  argc : argument count
+ * @param[in]  argv : argument vector
+ * -----------------------------------------------
+ */
+void shell_help(int argc, char *argv[])
+{
+    shell_t *shell = shell_get_current();
+    SHELL_ASSERT(shell);
+    if(argc == 1) {
+        shell_list_all(shell);
+    } else if(argc > 1) {
+        shell_write_cmd_help(shell, argv[1]);
+    }
+}
+
+SHELL_EXPORT_CMD(
+    SHELL_CMD_PERMISSION(0) | SHELL_CMD_TYPE(
+        SHELL_TYPE_CMD_MAIN) | SHELL_CMD_DISABLE_RETURN,
+    help, shell_help, show command info);
+
+
+#if SHELL_SUPPORT_END_LINE == 1 || SHELL_USING_LOCK == 1 || SHELL_USING_LOG == 1
+/**
+ * -----------------------------------------------
+ * @brief      shell write redraw
+ * @details    draw the prompt and the input line again
+ *             after output written over a cleared line
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * -----------------------------------------------
+ */
+static void shell_write_redraw(shell_t *shell)
+{
+#if SHELL_HISTORY_MAX_NUMBER > 0 && SHELL_HISTORY_SEARCH == 1
+    if(shell->history.search) {
+        shell_write_string(shell, "(reverse-i-search)'");
+        shell_write_data(shell, shell->history.pattern, shell->history.pattern_length);
+        shell_history_search_draw(shell);
+    } else
+#endif /** SHELL_HISTORY_MAX_NUMBER > 0 && SHELL_HISTORY_SEARCH == 1 */
+    {
+        shell_write_prompt(shell, 0);
+        /*! password is not echoed again */
+        if(shell->status.is_checked) {
+            shell_write_line(shell);
+        }
+    }
+}
+#endif /** SHELL_SUPPORT_END_LINE == 1 || SHELL_USING_LOCK == 1 || SHELL_USING_LOG == 1 */
+
+#if SHELL_SUPPORT_END_LINE == 1 || SHELL_USING_LOCK == 1
+/**
+ * -----------------------------------------------
+ * @brief      shell write async
+ * @details    write data above the input line, then draw
+ *             the prompt and the line again, called with
+ *             shell locked
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * @param[in]  data  : data to write
+ * @param[in]  length: data length
+ * -----------------------------------------------
+ */
+static void shell_write_async(shell_t *shell, const char *data, uint16_t length)
+{
+    if(shell->status.is_active) {
+        shell_write_data(shell, data, length);
+        return;
+    }
+    shell->output.hold++;
+    shell_write_string(shell, shell_text[SHELL_TEXT_CLEAR_LINE]);
+    shell_write_data(shell, data, length);
+    shell_write_redraw(shell);
+    shell->output.hold--;
+    shell_write_flush(shell);
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell write end line
+ * @details    write from any task without breaking the
+ *             line being typed
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * @param[in]  buffer: data to write
+ * @param[in]  len   : data length
+ * -----------------------------------------------
+ */
+void shell_write_end_line(shell_t *shell, char *buffer, int len)
+{
+    SHELL_LOCK(shell);
+    shell_write_async(shell, buffer, len);
+    SHELL_UNLOCK(shell);
+}
+#endif /** SHELL_SUPPORT_END_LINE == 1 || SHELL_USING_LOCK == 1 */
+
+#if SHELL_USING_LOG == 1
+/**
+ * -----------------------------------------------
+ * @brief      shell write log
+ * @details    write queued log records and drop counts above
+ *             the input line, the line is drawn again once per
+ *             batch, called by shell task
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * -----------------------------------------------
+ */
+void shell_write_log(shell_t *shell)
+{
+    char buffer[48];
+    const char *data;
+    uint16_t length;
+    uint32_t dropped;
+
+    if(!shell->log || !shell_log_pending(shell->log)) {
+        return;
+    }
+    SHELL_LOCK(shell);
+    shell->output.hold++;
+    if(!shell->status.is_active) {
+        shell_write_string(shell, shell_text[SHELL_TEXT_CLEAR_LINE]);
+    }
+    /*! records pushed while writing wait for the next batch */
+    for(uint16_t i = 0; i < SHELL_LOG_QUEUE_SIZE &&
+                        (length = shell_log_peek(shell->log, &data)) > 0; i++)
+    {
+        shell_write_data(shell, data, length);
+        shell_log_skip(shell->log);
+    }
+    for(uint8_t i = 0; i < SHELL_LOG_SOURCE_MAX; i++) {
+        if((dropped = shell_log_dropped(shell->log, i)) > 0) {
+            length = snprintf(buffer, sizeof(buffer), "log %u: %lu dropped\r\n",
+                              i, (unsigned long)dropped);
+            shell_write_data(shell, buffer, length);
+        }
+    }
+    if(!shell->status.is_active) {
+        shell_write_redraw(shell);
+    }
+    shell->output.hold--;
+    shell_write_flush(shell);
+    SHELL_UNLOCK(shell);
+}
+#endif /** SHELL_USING_LOG == 1 */
+
+/**
+ * -----------------------------------------------
+ * @brief      shell key call
+ * @details    run key function, a key unknown to reverse
+ *             search ends it first
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * @param[in]  key   : key command
+ * -----------------------------------------------
+ */
+static void shell_key_call(shell_t *shell, shell_cmd_t *key)
+{
+    void (*function)(shell_t *) = key->data.key.function;
+
+    if(!function) {
+        return;
+    }
+#if SHELL_HISTORY_MAX_NUMBER > 0 && SHELL_HISTORY_SEARCH == 1
+    if(shell->history.search && function != shell_history_search &&
+       function != shell_backspace && function != shell_enter)
+    {
+        shell_history_search_end(shell);
+    }
+#endif
+    function(shell);
+}
+
+#if SHELL_USING_KEY_MAP == 1
+/**
+ * -----------------------------------------------
+ * @brief      shell key map is lead
+ * -----------------------------------------------
+ * @param[in]  data : input byte
+ * -----------------------------------------------
+ * @return     int : non-zero if some key starts with data
+ * -----------------------------------------------
+ */
+static int shell_key_map_is_lead(char data)
+{
+    return shell_key_map.lead[(uint8_t)data >> 5] &
+           (1UL << ((uint8_t)data & 0x1F));
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell key map find
+ * @details    binary search the edges leaving state
+ * -----------------------------------------------
+ * @param[in]  state : current state
+ * @param[in]  data  : input byte
+ * -----------------------------------------------
+ * @return     int : edge position, -1 if not found
+ * -----------------------------------------------
+ */
+static int shell_key_map_find(uint8_t state, char data)
+{
+    uint8_t low = shell_key_map.first[state];
+    uint8_t high = shell_key_map.first[state + 1];
+    uint8_t mid;
+
+    while(low < high) {
+        mid = low + (high - low) / 2;
+        if((uint8_t)shell_key_map.edge[mid].data < (uint8_t)data) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return (low < shell_key_map.first[state + 1] &&
+            shell_key_map.edge[low].data == data) ? low : -1;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell key map add
+ * @details    add one key sequence to the transition table
+ * -----------------------------------------------
+ * @param[in]  key    : key command
+ * @param[in]  seq    : key byte sequence
+ * @param[in]  length : sequence length
+ * -----------------------------------------------
+ * @return     int : 0 success, -1 table full
+ * -----------------------------------------------
+ */
+static int shell_key_map_add(shell_cmd_t *key, const char *seq, uint8_t length)
+{
+    uint8_t state = 0;
+    uint8_t j;
+
+    for(uint8_t i = 0; i < length; i++) {
+        for(j = 0; j < shell_key_map.count; j++) {
+            if(shell_key_map.edge[j].state == state &&
+               shell_key_map.edge[j].data == seq[i])
+            {
+                break;
+            }
+        }
+        if(j == shell_key_map.count) {
+            if(shell_key_map.count >= SHELL_KEY_MAP_MAX) {
+                return -1;
+            }
+            shell_key_map.edge[j].state = state;
+            shell_key_map.edge[j].next = 0;
+            shell_key_map.edge[j].data = seq[i];
+            shell_key_map.edge[j].key = NULL;
+            shell_key_map.count++;
+        }
+        if(i == length - 1) {
+            /*! first registered key wins for the same sequence */
+            if(!shell_key_map.edge[j].key) {
+                shell_key_map.edge[j].key = key;
+            }
+        } else {
+            if(!shell_key_map.edge[j].next) {
+                if(shell_key_map.state_count > SHELL_KEY_MAP_MAX) {
+                    return -1;
+                }
+                shell_key_map.edge[j].next = shell_key_map.state_count++;
+            }
+            state = shell_key_map.edge[j].next;
+        }
+    }
+    if(length) {
+        shell_key_map.lead[(uint8_t)seq[0] >> 5] |= 1UL << ((uint8_t)seq[0] & 0x1F);
+    }
+    return 0;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell key sequence
+ * @details    byte sequence of key, a 4 byte value is
+ *             unpacked into packed
+ * -----------------------------------------------
+ * @param[in]  key    : key command
+ * @param[out] packed : 4 bytes buffer
+ * @param[out] length : sequence length
+ * -----------------------------------------------
+ * @return     const char* : key byte sequence
+ * -----------------------------------------------
+ */
+static const char *shell_key_seq(const shell_cmd_t *key, char *packed, uint8_t *length)
+{
+    uint8_t i;
+
+    if(key->attr.para.sequence) {
+        *length = strlen(key->data.key.seq);
+        return key->data.key.seq;
+    }
+    for(i = 0; i < 4; i++) {
+        packed[i] = (key->data.key.value >> (24 - 8 * i)) & 0xFF;
+        if(packed[i] == 0) {
+            break;
+        }
+    }
+    *length = i;
+    return packed;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell build key map
+ * @details    compile all keys of section into a transition
+ *             table, built once and shared by all shell,
+ *             keys beyond SHELL_KEY_MAP_MAX leave it unused
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * -----------------------------------------------
+ */
+static void shell_build_key_map(shell_t *shell)
+{
+    shell_cmd_t *base = (shell_cmd_t *)shell->key_list.base;
+    const char *seq;
+    char packed[4];
+    uint8_t length;
+
+    if(shell_key_map.is_valid) {
+        return;
+    }
+    shell_key_map.count = 0;
+    shell_key_map.state_count = 1;
+    for(uint16_t i = 0; i < shell->key_list.count; i++) {
+        seq = shell_key_seq(&base[i], packed, &length);
+        if(shell_key_map_add(&base[i], seq, length) != 0) {
+            goto full;
+        }
+    }
+#if SHELL_USING_DYNAMIC == 1
+    for(uint8_t i = 0; i < shell_dynamic.key_count; i++) {
+        seq = shell_key_seq(shell_dynamic.key[i], packed, &length);
+        if(shell_key_map_add((shell_cmd_t *)shell_dynamic.key[i], seq, length) != 0) {
+            goto full;
+        }
+    }
+#endif /** SHELL_USING_DYNAMIC == 1 */
+
+    /*! group edges by state, ordered by byte */
+    for(uint8_t i = 1; i < shell_key_map.count; i++) {
+        struct shell_key_edge edge = shell_key_map.edge[i];
+        uint8_t j = i;
+        while(j > 0 &&
+              (shell_key_map.edge[j - 1].state > edge.state ||
+               (shell_key_map.edge[j - 1].state == edge.state &&
+                (uint8_t)shell_key_map.edge[j - 1].data > (uint8_t)edge.data)))
+        {
+            shell_key_map.edge[j] = shell_key_map.edge[j - 1];
+            j--;
+        }
+        shell_key_map.edge[j] = edge;
+    }
+    for(uint8_t i = 0, j = 0; i <= shell_key_map.state_count; i++) {
+        while(j < shell_key_map.count && shell_key_map.edge[j].state < i) {
+            j++;
+        }
+        shell_key_map.first[i] = j;
+    }
+    shell_key_map.is_valid = 1;
+    return;
+full:
+    /*! too many keys, keep linear match on a clean table */
+    memset(&shell_key_map, 0, sizeof(shell_key_map));
+    shell_write_string(shell, shell_text[SHELL_TEXT_KEY_MAP_FULL]);
+}
+
+#if SHELL_USING_DYNAMIC == 1
+/**
+ * -----------------------------------------------
+ * @brief      shell key map free states
+ * -----------------------------------------------
+ * @param[out] state : a free state, 0 if none
+ * -----------------------------------------------
+ * @return     uint8_t : states may be taken
+ * -----------------------------------------------
+ */
+static uint8_t shell_key_map_free_states(uint8_t *state)
+{
+    uint8_t free = SHELL_KEY_MAP_MAX + 1 - shell_key_map.state_count;
+    uint8_t j;
+
+    *state = free ? shell_key_map.state_count : 0;
+    /*! states left by removed keys have no edge and no edge to them */
+    for(uint8_t s = shell_key_map.state_count - 1; s > 0; s--) {
+        if(shell_key_map.first[s] != shell_key_map.first[s + 1]) {
+            continue;
+        }
+        for(j = 0; j < shell_key_map.count && shell_key_map.edge[j].next != s; j++) {
+        }
+        if(j == shell_key_map.count) {
+            *state = s;
+            free++;
+        }
+    }
+    return free;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell key map insert edge
+ * @details    insert edge at its sorted position
+ * -----------------------------------------------
+ * @param[in]  state : from state
+ * @param[in]  data  : input byte
+ * -----------------------------------------------
+ * @return     uint8_t : edge position
+ * -----------------------------------------------
+ */
+static uint8_t shell_key_map_insert_edge(uint8_t state, char data)
+{
+    uint8_t pos = shell_key_map.first[state];
+
+    while(pos < shell_key_map.first[state + 1] &&
+          (uint8_t)shell_key_map.edge[pos].data < (uint8_t)data)
+    {
+        pos++;
+    }
+    memmove(&shell_key_map.edge[pos + 1], &shell_key_map.edge[pos],
+            (shell_key_map.count - pos) * sizeof(struct shell_key_edge));
+    shell_key_map.edge[pos].state = state;
+    shell_key_map.edge[pos].next = 0;
+    shell_key_map.edge[pos].data = data;
+    shell_key_map.edge[pos].key = NULL;
+    shell_key_map.count++;
+    for(uint8_t s = state + 1; s <= shell_key_map.state_count; s++) {
+        shell_key_map.first[s]++;
+    }
+    return pos;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell key map remove edge
+ * -----------------------------------------------
+ * @param[in]  pos : edge position
+ * -----------------------------------------------
+ */
+static void shell_key_map_remove_edge(uint8_t pos)
+{
+    uint8_t state = shell_key_map.edge[pos].state;
+
+    shell_key_map.count--;
+    memmove(&shell_key_map.edge[pos], &shell_key_map.edge[pos + 1],
+            (shell_key_map.count - pos) * sizeof(struct shell_key_edge));
+    for(uint8_t s = state + 1; s <= shell_key_map.state_count; s++) {
+        shell_key_map.first[s]--;
+    }
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell key map insert
+ * @details    add a runtime key to the built table in place,
+ *             a key sharing its end with another is refused,
+ *             since one of them could never match
+ * -----------------------------------------------
+ * @param[in]  key : key command
+ * -----------------------------------------------
+ * @return     int : 0 success, -1 conflict or table full
+ * -----------------------------------------------
+ */
+static int shell_key_map_insert(const shell_cmd_t *key)
+{
+    char packed[4];
+    uint8_t length;
+    const char *seq = shell_key_seq(key, packed, &length);
+    uint8_t state = 0;
+    uint8_t next;
+    uint8_t i;
+    int pos;
+
+    if(length == 0) {
+        return -1;
+    }
+    for(i = 0; i < length; i++) {
+        pos = shell_key_map_find(state, seq[i]);
+        if(pos < 0) {
+            break;
+        }
+        if(shell_key_map.edge[pos].key || i == length - 1) {
+            return -1;
+        }
+        state = shell_key_map.edge[pos].next;
+    }
+    if(shell_key_map.count + (length - i) > SHELL_KEY_MAP_MAX ||
+       shell_key_map_free_states(&next) < length - i - 1)
+    {
+        return -1;
+    }
+    for(; i < length; i++) {
+        pos = shell_key_map_insert_edge(state, seq[i]);
+        if(i == length - 1) {
+            shell_key_map.edge[pos].key = (shell_cmd_t *)key;
+            break;
+        }
+        shell_key_map_free_states(&next);
+        if(next == shell_key_map.state_count) {
+            /*! new state at the end, no edge yet */
+            shell_key_map.first[next + 1] = shell_key_map.count;
+            shell_key_map.state_count++;
+        }
+        shell_key_map.edge[pos].next = next;
+        state = next;
+    }
+    shell_key_map.lead[(uint8_t)seq[0] >> 5] |= 1UL << ((uint8_t)seq[0] & 0x1F);
+    return 0;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell key map remove
+ * @details    drop a runtime key and the edges only it used
+ * -----------------------------------------------
+ * @param[in]  key : key command
+ * -----------------------------------------------
+ */
+static void shell_key_map_remove(const shell_cmd_t *key)
+{
+    char packed[4];
+    uint8_t length;
+    const char *seq = shell_key_seq(key, packed, &length);
+    uint8_t state;
+    uint8_t next;
+    int pos = -1;
+
+    /*! prune from the last byte while an edge leads nowhere */
+    for(uint8_t depth = length; depth > 0; depth--) {
+        state = 0;
+        for(uint8_t i = 0; i < depth; i++) {
+            pos = shell_key_map_find(state, seq[i]);
+            if(pos < 0) {
+                return;
+            }
+            state = shell_key_map.edge[pos].next;
+        }
+        if(depth == length) {
+            if(shell_key_map.edge[pos].key != key) {
+                return;
+            }
+            shell_key_map.edge[pos].key = NULL;
+        }
+        next = shell_key_map.edge[pos].next;
+        if(shell_key_map.edge[pos].key ||
+           (next && shell_key_map.first[next] != shell_key_map.first[next + 1]))
+        {
+            return;
+        }
+        shell_key_map_remove_edge(pos);
+    }
+    shell_key_map.lead[(uint8_t)seq[0] >> 5] &= ~(1UL << ((uint8_t)seq[0] & 0x1F));
+}
+#endif /** SHELL_USING_DYNAMIC == 1 */
+
+/**
+ * -----------------------------------------------
+ * @brief      shell key input
+ * @details    step the key map with one byte, bytes which
+ *             cannot start a key return at once
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * @param[in]  data  : input byte
+ * -----------------------------------------------
+ * @return     int : 1 byte consumed by key, 0 normal input
+ * -----------------------------------------------
+ */
+static int shell_key_input(shell_t *shell, char data)
+{
+    int edge = -1;
+    shell_cmd_t *key;
+
+    if(shell->parser.key_state != 0) {
+        edge = shell_key_map_find(shell->parser.key_state, data);
+        shell->parser.key_state = 0;
+    }
+    if(edge < 0) {
+        if(!shell_key_map_is_lead(data)) {
+            return 0;
+        }
+        edge = shell_key_map_find(0, data);
+        if(edge < 0) {
+            return 0;
+        }
+    }
+
+    key = shell_key_map.edge[edge].key;
+    if(key) {
+        if(!SHELL_KEY_VISIBLE(shell, key)) {
+            return 0;
+        }
+        shell_key_call(shell, key);
+        return 1;
+    }
+    shell->parser.key_state = shell_key_map.edge[edge].next;
+    return 1;
+}
+#endif /** SHELL_USING_KEY_MAP == 1 */
+
+#if SHELL_USING_DYNAMIC == 1
+/**
+ * -----------------------------------------------
+ * @brief      shell lock all
+ * @details    lock every shell, none of them is then reading
+ *             the shared index, key map or runtime records
+ * -----------------------------------------------
+ */
+static void shell_lock_all(void)
+{
+    for(short i = 0; i < SHELL_MAX_NUMBER; i++) {
+        if(shell_list[i]) {
+            SHELL_LOCK(shell_list[i]);
+        }
+    }
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell unlock all
+ * -----------------------------------------------
+ */
+static void shell_unlock_all(void)
+{
+    for(short i = SHELL_MAX_NUMBER - 1; i >= 0; i--) {
+        if(shell_list[i]) {
+            SHELL_UNLOCK(shell_list[i]);
+        }
+    }
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell find name
+ * @details    cmd/var/user of name, section or runtime,
+ *             whatever the permission
+ * -----------------------------------------------
+ * @param[in]  name : name
+ * -----------------------------------------------
+ * @return     const shell_cmd_t* : item, NULL if none
+ * -----------------------------------------------
+ */
+static const shell_cmd_t *shell_find_name(const char *name)
+{
+    const shell_cmd_t *base = (const shell_cmd_t *)shell_sec_start;
+    size_t count = (shell_sec_end - shell_sec_start) / sizeof(shell_cmd_t);
+
+#if SHELL_USING_CMD_INDEX == 1
+    if(shell_cmd_index.is_valid) {
+        uint16_t low = shell_cmd_index_lower(name, strlen(name) + 1);
+        return (low < shell_cmd_index.count &&
+                strcmp(shell_cmd_index.item[low]->data.cmd.name, name) == 0)
+                   ? shell_cmd_index.item[low]
+                   : NULL;
+    }
+#endif /** SHELL_USING_CMD_INDEX == 1 */
+    for(size_t i = 0; i < count; i++) {
+        if(strcmp(base[i].data.cmd.name, name) == 0) {
+            return &base[i];
+        }
+    }
+    for(uint16_t i = 0; i < shell_dynamic.cmd_count; i++) {
+        if(strcmp(shell_dynamic.cmd[i]->data.cmd.name, name) == 0) {
+            return shell_dynamic.cmd[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell register dynamic
+ * @details    add a cmd/var/user or key at runtime, such as
+ *             from a module loaded after link, it joins the
+ *             index, key map, list and completion of every
+ *             shell at once, may be called while other shell
+ *             run, see SHELL_CMD_INIT & SHELL_KEY_INIT
+ * -----------------------------------------------
+ * @param[in]  command : record, kept by caller until unregistered
+ * -----------------------------------------------
+ * @return     int : 0 success, -1 pool full, name or key taken
+ * -----------------------------------------------
+ */
+int shell_register_dynamic(const shell_cmd_t *command)
+{
+    int ret = -1;
+
+    shell_lock_all();
+    if(command->attr.para.type == SHELL_TYPE_KEY) {
+        for(uint8_t i = 0; i < shell_dynamic.key_count; i++) {
+            if(shell_dynamic.key[i] == command) {
+                goto exit;
+            }
+        }
+        if(shell_dynamic.key_count >= SHELL_DYNAMIC_KEY_MAX) {
+            goto exit;
+        }
+#if SHELL_USING_KEY_MAP == 1
+        if(shell_key_map.is_valid && shell_key_map_insert(command) != 0) {
+            goto exit;
+        }
+#endif /** SHELL_USING_KEY_MAP == 1 */
+        shell_dynamic.key[shell_dynamic.key_count++] = command;
+    } else {
+        if(shell_dynamic.cmd_count >= SHELL_DYNAMIC_MAX ||
+           shell_find_name(command->data.cmd.name))
+        {
+            goto exit;
+        }
+#if SHELL_USING_CMD_INDEX == 1
+        if(shell_cmd_index.is_valid) {
+            shell_cmd_index_insert((shell_cmd_t *)command);
+        }
+#endif /** SHELL_USING_CMD_INDEX == 1 */
+        shell_dynamic.cmd[shell_dynamic.cmd_count++] = command;
+    }
+    ret = 0;
+exit:
+    shell_unlock_all();
+    return ret;
+}
 
 /**
  * -----------------------------------------------
- * @brief      shell backspace key input
- * @details    backspace key input shell
+ * @brief      shell unregister
+ * @details    remove a record added by shell_register_dynamic,
+ *             the user logged in on some shell is kept
  * -----------------------------------------------
- * @param[in]  shell : shell struct
+ * @param[in]  command : record
+ * -----------------------------------------------
+ * @return     int : 0 success, -1 not registered or in use
  * -----------------------------------------------
  */
-void shell_backspace(shell_t *shell)
+int shell_unregister(const shell_cmd_t *command)
 {
-    shell_delete_byte(shell, 1);
-}
+    int ret = -1;
+    uint16_t i;
 
-SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0) | SHELL_CMD_ENABLE_UNCHECKED,
-                 0x08000000, shell_backspace, backspace);
-SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0) | SHELL_CMD_ENABLE_UNCHECKED,
-                 0x7F000000, shell_backspace, backspace);
+    shell_lock_all();
+    if(command->attr.para.type == SHELL_TYPE_KEY) {
+        for(i = 0; i < shell_dynamic.key_count && shell_dynamic.key[i] != command; i++) {
+        }
+        if(i == shell_dynamic.key_count) {
+            goto exit;
+        }
+#if SHELL_USING_KEY_MAP == 1
+        if(shell_key_map.is_valid) {
+            shell_key_map_remove(command);
+        }
+#endif /** SHELL_USING_KEY_MAP == 1 */
+        /*! a key sequence half typed may have lost its state */
+        for(short j = 0; j < SHELL_MAX_NUMBER; j++) {
+            if(shell_list[j]) {
+                shell_list[j]->parser.key_state = 0;
+            }
+        }
+        shell_dynamic.key_count--;
+        memmove(&shell_dynamic.key[i], &shell_dynamic.key[i + 1],
+                (shell_dynamic.key_count - i) * sizeof(shell_cmd_t *));
+    } else {
+        for(i = 0; i < shell_dynamic.cmd_count && shell_dynamic.cmd[i] != command; i++) {
+        }
+        if(i == shell_dynamic.cmd_count) {
+            goto exit;
+        }
+        for(short j = 0; j < SHELL_MAX_NUMBER; j++) {
+            if(shell_list[j] && shell_list[j]->info.sh_cmd == command) {
+                goto exit;
+            }
+        }
+#if SHELL_USING_CMD_INDEX == 1
+        if(shell_cmd_index.is_valid) {
+            shell_cmd_index_remove((shell_cmd_t *)command);
+        }
+#endif /** SHELL_USING_CMD_INDEX == 1 */
+#if SHELL_USING_CMD_STATS == 1
+        shell_cmd_stats_remove(command);
+#endif /** SHELL_USING_CMD_STATS == 1 */
+        shell_dynamic.cmd_count--;
+        memmove(&shell_dynamic.cmd[i], &shell_dynamic.cmd[i + 1],
+                (shell_dynamic.cmd_count - i) * sizeof(shell_cmd_t *));
+    }
+    ret = 0;
+exit:
+    shell_unlock_all();
+    return ret;
+}
+#endif /** SHELL_USING_DYNAMIC == 1 */
 
 /**
  * -----------------------------------------------
- * @brief      shell delete key input
- * @details    delete key input shell
+ * @brief      shell key step
+ * @details    match input byte with a 4 byte key value,
+ *             call the key when all its bytes matched
  * -----------------------------------------------
- * @param[in]  shell : shell struct
+ * @param[in]  shell  : shell struct
+ * @param[in]  key    : key
+ * @param[in]  data   : input data, cleared once matched
+ * @param[in]  offset : bit offset of input byte in key value
+ * @param[in]  filter : mask of bytes matched before
+ * -----------------------------------------------
+ * @return     uint8_t : 1 key called
  * -----------------------------------------------
  */
-void shell_delete(shell_t *shell)
+static uint8_t shell_key_step(shell_t *shell, shell_cmd_t *key, char *data,
+                              char offset, int filter)
 {
-    shell_delete_byte(shell, -1);
+    if((key->data.key.value & filter) == shell->parser.key_value &&
+       (key->data.key.value & (0xFF << offset)) == (*data << offset))
+    {
+        shell->parser.key_value |= *data << offset;
+        *data = 0x00;
+        if(offset == 0 ||
+           (key->data.key.value & (0xFF << (offset - 8))) == 0x00000000)
+        {
+            shell_key_call(shell, key);
+            shell->parser.key_value = 0x00000000;
+            return 1;
+        }
+    }
+    return 0;
 }
 
-SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0) | SHELL_CMD_ENABLE_UNCHECKED,
-                 0x1B5B337E, shell_delete, delete);
-
 /**
  * -----------------------------------------------
- * @brief      shell enter key input
- * @details    enter key input shell
+ * @brief      shell key sequence step
+ * @details    match input byte with a key sequence, keys
+ *             matched so far share parser.key_state bytes
+ *             with parser.key_seq
  * -----------------------------------------------
- * @param[in]  shell : shell struct
+ * @param[in]  shell   : shell struct
+ * @param[in]  key     : sequence key
+ * @param[in]  data    : input data
+ * @param[out] matched : bytes matched if key goes on
+ * -----------------------------------------------
+ * @return     uint8_t : 1 key called
  * -----------------------------------------------
  */
-void shell_enter(shell_t *shell)
+static uint8_t shell_key_seq_step(shell_t *shell, shell_cmd_t *key, char data,
+                                  uint8_t *matched)
 {
-    shell_exec(shell);
-    shell_write_prompt(shell, 1);
-}
+    const char *seq = key->data.key.seq;
+    uint8_t offset = shell->parser.key_state;
 
-#if SHELL_ENTER_LF == 1
-SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0) | SHELL_CMD_ENABLE_UNCHECKED,
-                 0x0A000000, shell_enter, enter);
-#endif
-#if SHELL_ENTER_CR == 1
-SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0) | SHELL_CMD_ENABLE_UNCHECKED,
-                 0x0D000000, shell_enter, enter);
-#endif
-#if SHELL_ENTER_CRLF == 1
-SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0) | SHELL_CMD_ENABLE_UNCHECKED,
-                 0x0D0A0000, shell_enter, enter);
-#endif
+    if(seq[offset] != data ||
+       (offset && strncmp(seq, shell->parser.key_seq, offset) != 0))
+    {
+        return 0;
+    }
+    if(seq[offset + 1] == 0) {
+        shell_key_call(shell, key);
+        shell->parser.key_value = 0x00000000;
+        return 1;
+    }
+    shell->parser.key_seq = seq;
+    *matched = offset + 1;
+    return 0;
+}
 
 /**
  * -----------------------------------------------
- * @brief      shell write command help
- * @details    write command help shell
+ * @brief      shell input dispatch
+ * @details    match input byte with keys,
+ *             or insert it as normal input
  * -----------------------------------------------
  * @param[in]  shell : shell struct
- * @param[in]  cmd   : command string
+ * @param[in]  data  : input data
  * -----------------------------------------------
  */
-static void shell_write_cmd_help(shell_t *shell, char *cmd)
+static void shell_input_dispatch(shell_t *shell, char data)
 {
-    shell_cmd_t *command = shell_seek_cmd(shell,
-                                          cmd,
-                                          shell->command_list.base,
-                                          0);
-    if(command) {
-        shell_write_string(shell, shell_text[SHELL_TEXT_HELP_HEADER]);
-        shell_write_string(shell, shell_get_command_name(command));
-        shell_write_string(shell, "\r\n");
-        shell_write_string(shell, shell_get_command_desc(command));
-        shell_write_string(shell, "\r\n");
-    } else {
-        shell_write_string(shell, shell_text[SHELL_TEXT_CMD_NOT_FOUND]);
+#if SHELL_USING_KEY_MAP == 1
+    if(shell_key_map.is_valid) {
+        if(!shell_key_input(shell, data)) {
+            shell_normal_input(shell, data);
+        }
+        return;
+    }
+#endif /** SHELL_USING_KEY_MAP == 1 */
+
+    char keyByteOffset = 24;
+    int keyFilter = 0x00000000;
+    if((shell->parser.key_value & 0x0000FF00) != 0x00000000) {
+        keyByteOffset = 0;
+        keyFilter = 0xFFFFFF00;
+    } else if((shell->parser.key_value & 0x00FF0000) != 0x00000000) {
+        keyByteOffset = 8;
+        keyFilter = 0xFFFF0000;
+    } else if((shell->parser.key_value & 0xFF000000) != 0x00000000) {
+        keyByteOffset = 16;
+        keyFilter = 0xFF000000;
+    }
+
+    shell_cmd_t *base = (shell_cmd_t *)shell->key_list.base;
+    shell_cmd_t *key;
+    char input = data;
+    uint8_t matched = 0;
+    uint8_t done = 0;
+    for(uint16_t i = SHELL_NEXT_KEY(shell, 0); i < shell->key_list.count && !done;
+        i = SHELL_NEXT_KEY(shell, i + 1))
+    {
+        key = &base[i];
+        done = key->attr.para.sequence
+             ? shell_key_seq_step(shell, key, input, &matched)
+             : shell_key_step(shell, key, &data, keyByteOffset, keyFilter);
+    }
+#if SHELL_USING_DYNAMIC == 1
+    /*! runtime keys follow the section */
+    for(uint8_t i = 0; i < shell_dynamic.key_count && !done; i++) {
+        if(SHELL_KEY_VISIBLE(shell, shell_dynamic.key[i])) {
+            key = (shell_cmd_t *)shell_dynamic.key[i];
+            done = key->attr.para.sequence
+                 ? shell_key_seq_step(shell, key, input, &matched)
+                 : shell_key_step(shell, key, &data, keyByteOffset, keyFilter);
+        }
+    }
+#endif /** SHELL_USING_DYNAMIC == 1 */
+
+    shell->parser.key_state = done ? 0 : matched;
+    if(data != 0x00) {
+        shell->parser.key_value = 0x00000000;
+        if(!done && !matched) {
+            shell_normal_input(shell, data);
+        }
     }
 }
 
 /**
  * -----------------------------------------------
- * @brief      shell help command
- * @details    show command help shell
+ * @brief      shell input run
+ * @details    length of leading printable bytes which
+ *             cannot start a key, 0 if not batchable
  * -----------------------------------------------
- * @param[in]  argc : argument count
- * @param[in]  argv : argument vector
+ * @param[in]  shell : shell struct
+ * @param[in]  data  : input data
+ * @param[in]  length: input data length
+ * -----------------------------------------------
+ * @return     uint16_t : run length
  * -----------------------------------------------
  */
-void shell_help(int argc, char *argv[])
+static uint16_t shell_input_run(shell_t *shell, const char *data, uint16_t length)
 {
-    shell_t *shell = shell_get_current();
-    SHELL_ASSERT(shell);
-    if(argc == 1) {
-        shell_list_all(shell);
-    } else if(argc > 1) {
-        shell_write_cmd_help(shell, argv[1]);
-    }
-}
-
-SHELL_EXPORT_CMD(
-    SHELL_CMD_PERMISSION(0) | SHELL_CMD_TYPE(
-        SHELL_TYPE_CMD_MAIN) | SHELL_CMD_DISABLE_RETURN,
-    help, shell_help, show command info);
+    uint16_t run = 0;
 
-
-#if SHELL_SUPPORT_END_LINE == 1
-void shellWriteEndLine(shell_t *shell, char *buffer, int len)
-{
-    SHELL_LOCK(shell);
-    if (!shell->status.is_active)
+#if SHELL_HISTORY_MAX_NUMBER > 0 && SHELL_HISTORY_SEARCH == 1
+    if(shell->history.search) {
+        return 0;
+    }
+#endif
+#if SHELL_USING_KEY_MAP == 1
+    if(!shell_key_map.is_valid || shell->parser.key_state != 0 ||
+       !shell->status.is_checked)
     {
-        shell_write_string(shell, shell_text[SHELL_TEXT_CLEAR_LINE]);
+        return 0;
     }
-    shell->write(buffer, len);
-
-    if (!shell->status.is_active)
+    while(run < length && data[run] >= ' ' && data[run] < 0x7F &&
+          !shell_key_map_is_lead(data[run]))
     {
-        shell_write_prompt(shell, 0);
-        if (shell->parser.length > 0)
-        {
-            shell_write_string(shell, shell->parser.buffer);
-            for (short i = 0; i < shell->parser.length - shell->parser.cursor; i++)
-            {
-                shell_write_byte(shell, '\b');
-            }
-        }
+        run++;
     }
-    SHELL_UNLOCK(shell);
+#endif /** SHELL_USING_KEY_MAP == 1 */
+    return run;
 }
-#endif /** SHELL_SUPPORT_END_LINE == 1 */
 
 /**
  * -----------------------------------------------
@@ -1770,7 +4290,27 @@ void shellWriteEndLine(shell_t *shell, char *buffer, int len)
 void shell_handler(shell_t *shell, char data)
 {
     SHELL_ASSERT(data);
+    shell_handler_block(shell, &data, 1);
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell input block handler
+ * @details    handle a block of shell input, runs of
+ *             printable bytes are inserted and echoed
+ *             at once, zero bytes are ignored
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * @param[in]  data  : input data
+ * @param[in]  length: input data length
+ * -----------------------------------------------
+ */
+void shell_handler_block(shell_t *shell, const char *data, uint16_t length)
+{
+    uint16_t run;
+
     SHELL_LOCK(shell);
+    shell->output.hold++;
 
 #if SHELL_LOCK_TIMEOUT > 0
     if(shell->info.sh_cmd->data.user.pasd &&
@@ -1782,53 +4322,30 @@ void shell_handler(shell_t *shell, char data)
     }
 #endif
 
-    char keyByteOffset = 24;
-    int keyFilter = 0x00000000;
-    if((shell->parser.key_value & 0x0000FF00) != 0x00000000) {
-        keyByteOffset = 0;
-        keyFilter = 0xFFFFFF00;
-    } else if((shell->parser.key_value & 0x00FF0000) != 0x00000000) {
-        keyByteOffset = 8;
-        keyFilter = 0xFFFF0000;
-    } else if((shell->parser.key_value & 0xFF000000) != 0x00000000) {
-        keyByteOffset = 16;
-        keyFilter = 0xFF000000;
-    }
-
-    shell_cmd_t *base = (shell_cmd_t *)shell->command_list.base;
-    for(short i = 0; i < shell->command_list.count; i++) {
-        if(base[i].attr.para.type == SHELL_TYPE_KEY &&
-           shell_check_permission(shell, &(base[i])) == 0)
-        {
-            if((base[i].data.key.value & keyFilter) ==
-               shell->parser.key_value &&
-               (base[i].data.key.value & (0xFF << keyByteOffset)) ==
-               (data << keyByteOffset))
-            {
-                shell->parser.key_value |= data << keyByteOffset;
-                data = 0x00;
-                if(keyByteOffset == 0 ||
-                   (base[i].data.key.value & (0xFF << (keyByteOffset - 8))) ==
-                   0x00000000)
-                {
-                    if(base[i].data.key.function) {
-                        base[i].data.key.function(shell);
-                    }
-                    shell->parser.key_value = 0x00000000;
-                    break;
-                }
+    for(uint16_t i = 0; i < length; i += run) {
+#if SHELL_USING_RPC == 1
+        if(shell->rpc.active) {
+            run = shell_rpc_input(shell, data + i, length - i);
+            continue;
+        }
+#endif /** SHELL_USING_RPC == 1 */
+        run = shell_input_run(shell, data + i, length - i);
+        if(run > 1) {
+            shell->status.tab_flag = 0;
+            shell_insert_block(shell, data + i, run);
+        } else {
+            run = 1;
+            if(data[i]) {
+                shell_input_dispatch(shell, data[i]);
             }
         }
     }
 
-    if(data != 0x00) {
-        shell->parser.key_value = 0x00000000;
-        shell_normal_input(shell, data);
-    }
-
     if(SHELL_GET_TICK()) {
         shell->info.active_time = SHELL_GET_TICK();
     }
+    shell->output.hold--;
+    shell_write_flush(shell);
     SHELL_UNLOCK(shell);
 }
 
@@ -1846,13 +4363,19 @@ void shell_handler(shell_t *shell, char data)
 void shell_task(void *param)
 {
     shell_t *shell = (shell_t *)param;
-    char data;
+    char data[SHELL_TASK_READ_SIZE];
+    signed short length;
 #if SHELL_TASK_WHILE == 1
     while(1) {
 #endif
-    if(shell->read && shell->read(&data, 1) == 1) {
-        shell_handler(shell, data);
+    if(shell->read &&
+       (length = shell->read(data, SHELL_TASK_READ_SIZE)) > 0)
+    {
+        shell_handler_block(shell, data, length);
     }
+#if SHELL_USING_LOG == 1
+    shell_write_log(shell);
+#endif /** SHELL_USING_LOG == 1 */
 #if SHELL_TASK_WHILE == 1
 }
 
@@ -1972,6 +4495,134 @@ SHELL_EXPORT_CMD(
         SHELL_TYPE_CMD_FUNC) | SHELL_CMD_DISABLE_RETURN,
     clear, shell_clear, clear console);
 
+#if SHELL_USING_CMD_STATS == 1
+/**
+ * -----------------------------------------------
+ * @brief      record cmd execution time
+ * @details    never waits, the sample is dropped if the
+ *             stats are busy
+ * -----------------------------------------------
+ * @param[in]  command : cmd executed
+ * @param[in]  time    : execution time in hrtick
+ * -----------------------------------------------
+ */
+static void shell_cmd_stats_record(const shell_cmd_t *command, uint32_t time)
+{
+    struct shell_cmd_stat *stat = NULL;
+    uint8_t bucket = 0;
+
+    if(!SHELL_STATS_TRY_LOCK()) {
+        return;
+    }
+    for(short i = 0; i < SHELL_CMD_STATS_MAX; i++) {
+        if(shell_cmd_stats[i].cmd == command || shell_cmd_stats[i].cmd == NULL) {
+            stat = &shell_cmd_stats[i];
+            break;
+        }
+    }
+    if(stat == NULL) {
+        SHELL_STATS_UNLOCK();
+        return;
+    }
+    if(stat->cmd == NULL) {
+        stat->cmd = command;
+        stat->min = time;
+    }
+    stat->count++;
+    stat->last = time;
+    if(time < stat->min) {
+        stat->min = time;
+    }
+    if(time > stat->max) {
+        stat->max = time;
+    }
+    while(time && bucket < SHELL_CMD_STATS_BUCKETS - 1) {
+        time >>= 1;
+        bucket++;
+    }
+    stat->hist[bucket]++;
+    SHELL_STATS_UNLOCK();
+}
+
+#if SHELL_USING_DYNAMIC == 1
+/**
+ * -----------------------------------------------
+ * @brief      drop stats of an unregistered cmd
+ * -----------------------------------------------
+ * @param[in]  command : cmd
+ * -----------------------------------------------
+ */
+static void shell_cmd_stats_remove(const shell_cmd_t *command)
+{
+    while(!SHELL_STATS_TRY_LOCK()) {
+    }
+    for(short i = 0; i < SHELL_CMD_STATS_MAX && shell_cmd_stats[i].cmd; i++) {
+        if(shell_cmd_stats[i].cmd == command) {
+            memmove(&shell_cmd_stats[i], &shell_cmd_stats[i + 1],
+                    (SHELL_CMD_STATS_MAX - 1 - i) * sizeof(shell_cmd_stats[0]));
+            memset(&shell_cmd_stats[SHELL_CMD_STATS_MAX - 1], 0, sizeof(shell_cmd_stats[0]));
+            break;
+        }
+    }
+    SHELL_STATS_UNLOCK();
+}
+#endif /** SHELL_USING_DYNAMIC == 1 */
+
+#if SHELL_PRINT_BUFFER > 0
+/**
+ * -----------------------------------------------
+ * @brief      shell stats command
+ * @details    show cmd execution stats, `stats clear` to reset
+ * -----------------------------------------------
+ */
+int shell_stats(int argc, char *argv[])
+{
+    shell_t *shell = shell_get_current();
+    struct shell_cmd_stat copy;
+    struct shell_cmd_stat *stat = &copy;
+
+    if(!shell) {
+        return -1;
+    }
+    if(argc > 1 && strcmp(argv[1], "clear") == 0) {
+        while(!SHELL_STATS_TRY_LOCK()) {
+        }
+        memset(shell_cmd_stats, 0, sizeof(shell_cmd_stats));
+        SHELL_STATS_UNLOCK();
+        return 0;
+    }
+    shell_print(shell, "%-20s %10s %10s %10s %10s\r\n",
+                "cmd", "count", "last", "min", "max");
+    for(short i = 0; i < SHELL_CMD_STATS_MAX; i++) {
+        /*! copied out, printing may block */
+        while(!SHELL_STATS_TRY_LOCK()) {
+        }
+        copy = shell_cmd_stats[i];
+        SHELL_STATS_UNLOCK();
+        if(copy.cmd == NULL) {
+            break;
+        }
+        shell_print(shell, "%-20s %10u %10u %10u %10u\r\n",
+                    shell_get_command_name((shell_cmd_t *)stat->cmd), (unsigned)stat->count,
+                    (unsigned)stat->last, (unsigned)stat->min, (unsigned)stat->max);
+        shell_write_string(shell, "    hist");
+        for(short j = 0; j < SHELL_CMD_STATS_BUCKETS; j++) {
+            if(stat->hist[j]) {
+                shell_print(shell, " <2^%d:%u", j, (unsigned)stat->hist[j]);
+            }
+        }
+        shell_write_string(shell, "\r\n");
+    }
+    return 0;
+}
+
+SHELL_EXPORT_CMD(
+    SHELL_CMD_PERMISSION(0) | SHELL_CMD_TYPE(
+        SHELL_TYPE_CMD_MAIN) | SHELL_CMD_DISABLE_RETURN,
+    stats, shell_stats, show cmd execution stats);
+#endif /** SHELL_PRINT_BUFFER > 0 */
+#endif /** SHELL_USING_CMD_STATS == 1 */
+
 /**
  * -----------------------------------------------
  * @brief      shell run command
@@ -1985,19 +4636,104 @@ SHELL_EXPORT_CMD(
 int shell_run(shell_t *shell, const char *cmd)
 {
     SHELL_ASSERT(shell && cmd);
-    char active = shell->status.is_active;
+    char active;
+    SHELL_LOCK(shell);
+    active = shell->status.is_active;
     if(strlen(cmd) > shell->parser.buffer_size - 1) {
         shell_write_string(shell, shell_text[SHELL_TEXT_CMD_TOO_LONG]);
+        SHELL_UNLOCK(shell);
         return -1;
     } else {
         shell->parser.length = shell_string_copy(shell->parser.buffer,
                                                  (char *)cmd);
+        shell->parser.cursor = shell->parser.length;
+        shell->output.hold++;
         shell_exec(shell);
+        shell->output.hold--;
+        shell_write_flush(shell);
         shell->status.is_active = active;
+        SHELL_UNLOCK(shell);
         return 0;
     }
 }
 
+#if SHELL_CAPTURE_LINE_MAX > 0
+/**
+ * -----------------------------------------------
+ * @brief      shell run command, capture output
+ * @details    output of cmd is written straight into buffer
+ *             instead of shell write, the line being typed,
+ *             history, params of a running cmd and the user
+ *             are kept, a user switched to in cmd holds for
+ *             the rest of cmd only, so another task or a cmd
+ *             may call it at any time, output beyond size - 1
+ *             is dropped and buffer is always terminated, output
+ *             written by cmd through shell write itself is not
+ *             captured
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * @param[in]  cmd   : command string, `a; b && c` allowed
+ * @param[out] buffer: captured output
+ * @param[in]  size  : buffer size
+ * @param[out] ret   : return value of last cmd run, may be NULL
+ * -----------------------------------------------
+ * @return     int : captured length, -1 if cmd is too long or no buffer
+ * -----------------------------------------------
+ */
+int shell_run_capture(shell_t *shell, const char *cmd, char *buffer, uint16_t size, int *ret)
+{
+    char line[SHELL_CAPTURE_LINE_MAX];
+    char *param[SHELL_PARAMETER_MAX_NUMBER];
+    uint16_t param_count;
+    shell_output_save_t save;
+    const shell_cmd_t *user;
+    size_t length;
+    char active;
+    char checked;
+    int value;
+
+    SHELL_ASSERT(shell && cmd && buffer);
+    length = strlen(cmd);
+    if(size == 0) {
+        return -1;
+    }
+    if(length >= SHELL_CAPTURE_LINE_MAX) {
+        buffer[0] = 0;
+        return -1;
+    }
+    /*! cmd is split in place, parser buffer holds the typed line */
+    memcpy(line, cmd, length + 1);
+
+    SHELL_LOCK(shell);
+    active = shell->status.is_active;
+    user = shell->info.sh_cmd;
+    checked = shell->status.is_checked;
+    param_count = shell->parser.param_count;
+    memcpy(param, shell->parser.param, sizeof(param));
+    shell_capture_begin(shell, &save, buffer, size - 1);
+    value = shell_exec_sequence(shell, line, length, 0);
+    length = shell_capture_end(shell, &save);
+    memcpy(shell->parser.param, param, sizeof(param));
+    shell->parser.param_count = param_count;
+    shell->status.is_active = active;
+    if(shell->info.sh_cmd != user) {
+        /*! a user record was run, the operator keeps the session */
+        shell->info.sh_cmd = user;
+#if SHELL_USING_VISIBLE_MAP == 1
+        shell_build_visible(shell);
+#endif /** SHELL_USING_VISIBLE_MAP == 1 */
+    }
+    shell->status.is_checked = checked;
+    SHELL_UNLOCK(shell);
+
+    buffer[length] = 0;
+    if(ret) {
+        *ret = value;
+    }
+    return length;
+}
+#endif /** SHELL_CAPTURE_LINE_MAX > 0 */
+
 #if SHELL_KEEP_RETURN_VALUE == 1
 /**
  * @brief shell返回值获取
@@ -2024,75 +4760,6 @@ SHELL_EXPORT_VAR(SHELL_CMD_PERMISSION(0) | SHELL_CMD_TYPE(
 /*---------------------------  shell register  --------------------------------*/
 /*-----------------------------------------------------------------------------*/
 /*-----------------------------------------------------------------------------*/
-/**
- * -----------------------------------------------
- * @brief      shell parse number type
- * @details    parse number type from string
- * -----------------------------------------------
- * @param[in]  string number string
- * @param[out] type number type
- * @return     SHELL_NUM_TYPE_E number type
- * -----------------------------------------------
- */
-static SHELL_NUM_TYPE_E shell_register_num_type(char *string)
-{
-    char *p = string;
-    SHELL_NUM_TYPE_E type = NUM_TYPE_DEC;
-
-    if ((*p == '0') && ((*(p + 1) == 'x') || (*(p + 1) == 'X')))
-    {
-        type = NUM_TYPE_HEX;
-    }
-    else if ((*p == '0') && ((*(p + 1) == 'b') || (*(p + 1) == 'B')))
-    {
-        type = NUM_TYPE_BIN;
-    }
-    else if (*p == '0')
-    {
-        type = NUM_TYPE_OCT;
-    }
-    
-    while (*p++)
-    {
-        if (*p == '.' && *(p + 1) != 0)
-        {
-            type = NUM_TYPE_FLOAT;
-            break;
-        }
-    }
-
-    return type;
-}
-
-/**
- * -----------------------------------------------
- * @brief      shell char to number
- * @details    convert char to number
- * -----------------------------------------------
- * @param[in]  code char to convert
- * @return     char number
- * -----------------------------------------------
- */
-static char shell_register_char_to_num(char code)
-{
-    if ((code >= '0') && (code <= '9'))
-    {
-        return code -'0';
-    }
-    else if ((code >= 'a') && (code <= 'f'))
-    {
-        return code - 'a' + 10;
-    }
-    else if ((code >= 'A') && (code <= 'F'))
-    {
-        return code - 'A' + 10;
-    }
-    else
-    {
-        return 0;
-    }
-}
-
 /**
  * -----------------------------------------------
  * @brief      shell parse char
@@ -2182,74 +4849,44 @@ static char* shell_register_parse_string(char *string)
 /**
  * -----------------------------------------------
  * @brief      shell parse number
- * @details    parse number from string
+ * @details    parse number from string, real is passed
+ *             as float bits, see SHELL_PARAM_FLOAT
  * -----------------------------------------------
  * @param[in]  string number string
- * @return     size_t number value
+ * @param[out] result number value
+ * @return     int 0 parse success -1 parse fail or out of range
  * -----------------------------------------------
  */
-static size_t shell_register_parse_number(char *string)
+static int shell_register_parse_number(char *string, size_t *result)
 {
-    SHELL_NUM_TYPE_E type = NUM_TYPE_DEC;
-    char radix = 10;
-    char *p = string;
-    char offset = 0;
-    signed char sign = 1;
-    size_t value_int = 0;
-    float value_float = 0.0;
-    size_t devide = 0;
-
-    if (*string == '-')
-    {
-        sign = -1;
-    }
+    shell_number_t number;
+    int64_t value;
+    float value_float;
 
-    type = shell_register_num_type(string + ((sign == -1) ? 1 : 0));
-
-    switch ((char)type)
+    if (shell_number_parse(string, &number) != SHELL_NUMBER_OK)
     {
-    case NUM_TYPE_HEX:
-        radix = 16;
-        offset = 2;
-        break;
-    
-    case NUM_TYPE_OCT:
-        radix = 8;
-        offset = 1;
-        break;
-
-    case NUM_TYPE_BIN:
-        radix = 2;
-        offset = 2;
-        break;
-    
-    default:
-        break;
+        return -1;
     }
-
-    p = string + offset + ((sign == -1) ? 1 : 0);
-
-    while (*p)
+    if (number.is_real)
     {
-        if (*p == '.')
+        if (shell_number_float(&number, &value_float) != SHELL_NUMBER_OK)
         {
-            devide = 1;
-            p++;
-            continue;
+            return -1;
         }
-        value_int = value_int * radix + shell_register_char_to_num(*p);
-        devide *= 10;
-        p++;
-    }
-    if (type == NUM_TYPE_FLOAT && devide != 0)
-    {
-        value_float = (float)value_int / devide * sign;
-        return *(size_t *)(&value_float);
+        *result = 0;
+        memcpy(result, &value_float, sizeof(value_float));
+        return 0;
     }
-    else
+    value = shell_number_int(&number);
+    /*! accept both signed and unsigned range of size_t */
+    if (sizeof(size_t) < sizeof(value) &&
+        (value < -(1LL << (sizeof(size_t) * 8 - 1)) ||
+         (!number.is_negative && (number.mantissa >> (sizeof(size_t) * 8)))))
     {
-        return value_int * sign;
+        return -1;
     }
+    *result = (size_t)value;
+    return 0;
 }
 
 /**
@@ -2303,8 +4940,7 @@ static int shell_register_parse_para(shell_t *shell, char *string, char *type, s
         }
         else if (*string == '-' || (*string >= '0' && *string <= '9'))
         {
-            *result = shell_register_parse_number(string);
-            return 0;
+            return shell_register_parse_number(string, result);
         }
         else if (*string == '$' && *(string + 1))
         {
@@ -2319,6 +4955,113 @@ static int shell_register_parse_para(shell_t *shell, char *string, char *type, s
     return -1;
 }
 
+/**
+ * -----------------------------------------------
+ * @brief      shell parse typed param
+ * @details    parse param straight into its declared type,
+ *             used by SHELL_EXPORT_CMD_TYPED thunk
+ * -----------------------------------------------
+ * @param[in]  string param string
+ * @param[out] value param value
+ * @param[in]  type param kind | param size, see SHELL_ARG_TYPE
+ * @return     int 0 parse success -1 parse fail or out of range
+ * -----------------------------------------------
+ */
+int shell_arg_parse(char *string, void *value, uint8_t type)
+{
+    uint8_t size = type & 0x0F;
+    shell_number_t number;
+    int64_t integer;
+    uint64_t limit;
+    size_t var;
+
+    switch (type & 0xF0)
+    {
+    case SHELL_ARG_STRING:
+        *(char **)value = shell_register_parse_string(string);
+        return 0;
+
+    case SHELL_ARG_FLOAT:
+        if (shell_number_parse(string, &number) != SHELL_NUMBER_OK)
+        {
+            return -1;
+        }
+        if (size == sizeof(float))
+        {
+            return shell_number_float(&number, (float *)value) == SHELL_NUMBER_OK ? 0 : -1;
+        }
+        return shell_number_double(&number, (double *)value) == SHELL_NUMBER_OK ? 0 : -1;
+
+    case SHELL_ARG_CHAR:
+        if (*string == '\'' && *(string + 1))
+        {
+            *(char *)value = shell_register_parse_char(string);
+            return 0;
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    if (*string == '$' && *(string + 1))
+    {
+        if (shell_register_parse_var(shell_get_current(), string, &var) != 0)
+        {
+            return -1;
+        }
+        integer = (int64_t)var;
+    }
+    else
+    {
+        if (shell_number_parse(string, &number) != SHELL_NUMBER_OK ||
+            number.is_real)
+        {
+            return -1;
+        }
+        /*! signed in [-2^(n-1), 2^(n-1) - 1], unsigned in [0, 2^n - 1],
+            char takes either */
+        limit = (size < sizeof(limit)) ? (1ULL << (size * 8)) - 1 : UINT64_MAX;
+        if ((type & 0xF0) == SHELL_ARG_SIGNED)
+        {
+            limit >>= 1;
+            if (number.mantissa > limit + number.is_negative)
+            {
+                return -1;
+            }
+        }
+        else if ((type & 0xF0) == SHELL_ARG_UNSIGNED)
+        {
+            if ((number.is_negative && number.mantissa) || number.mantissa > limit)
+            {
+                return -1;
+            }
+        }
+        else if (number.mantissa > (number.is_negative ? (limit >> 1) + 1 : limit))
+        {
+            return -1;
+        }
+        integer = shell_number_int(&number);
+    }
+
+    switch (size)
+    {
+    case 1:
+        *(uint8_t *)value = (uint8_t)integer;
+        break;
+    case 2:
+        *(uint16_t *)value = (uint16_t)integer;
+        break;
+    case 4:
+        *(uint32_t *)value = (uint32_t)integer;
+        break;
+    default:
+        *(uint64_t *)value = (uint64_t)integer;
+        break;
+    }
+    return 0;
+}
+
 /**
  * -----------------------------------------------
  * @brief      shell run command
@@ -2347,6 +5090,28 @@ int shell_register_run(shell_t *shell, shell_cmd_t *command, int argc, char *arg
             }
         }
     }
+    SHELL_STATS_START();
+    ret = shell_register_call(command, params, param_number);
+    SHELL_STATS_STOP(command);
+
+    return ret;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell call func cmd
+ * @details    call func cmd with parsed params
+ * -----------------------------------------------
+ * @param[in]  command cmd to call
+ * @param[in]  params cmd params
+ * @param[in]  param_number params number
+ * @return     cmd func return value, -1 if too many params
+ * -----------------------------------------------
+ */
+static int shell_register_call(shell_cmd_t *command, size_t *params, int param_number)
+{
+    int ret = 0;
+
     switch (param_number)
     {
 #if SHELL_PARAMETER_MAX_NUMBER >= 1
@@ -2495,6 +5260,335 @@ int shell_register_run(shell_t *shell, shell_cmd_t *command, int argc, char *arg
         ret = -1;
         break;
     }
-    
+
     return ret;
-}
\ No newline at end of file
+}
+
+#if SHELL_USING_RPC == 1
+/*-----------------------------------------------------------------------------*/
+/**
+ * rpc frame, multi-byte fields are little endian
+ *   request : 0xA5 | len(2) | op(1) | body(len - 1) | crc16(2)
+ *   reply   : 0xA5 | len(2) | status(1) | ret(4) | index(2) | output | crc16(2)
+ * crc16 ccitt (0x1021, init 0xFFFF) covers len and the bytes after it
+ *
+ * op
+ *   SHELL_RPC_OP_EXIT : leave rpc mode, so does ctrl-c or enter
+ *                       typed out of a frame
+ *   SHELL_RPC_OP_INDEX: index(2) | argc(1) | args, index in cmd section
+ *   SHELL_RPC_OP_NAME : name(string) | argc(1) | args
+ *   SHELL_RPC_OP_LINE : line(string), cmd sequence as typed
+ * arg
+ *   'i' | int32(4)
+ *   's' | string, string is len(1) | bytes | 0x00, len counts 0x00
+ * reply index is the cmd section index, for later SHELL_RPC_OP_INDEX
+ */
+#define SHELL_RPC_SYNC                  0xA5
+#define SHELL_RPC_HEAD                  3
+#define SHELL_RPC_REPLY_HEAD            10
+#define SHELL_RPC_CRC                   2
+
+enum {
+    SHELL_RPC_OP_EXIT = 0,
+    SHELL_RPC_OP_INDEX,
+    SHELL_RPC_OP_NAME,
+    SHELL_RPC_OP_LINE,
+};
+
+enum {
+    SHELL_RPC_OK = 0,
+    SHELL_RPC_ERROR_CRC,
+    SHELL_RPC_ERROR_LENGTH,
+    SHELL_RPC_ERROR_OP,
+    SHELL_RPC_ERROR_NOT_FOUND,
+    SHELL_RPC_ERROR_ARGS,
+};
+
+/**
+ * -----------------------------------------------
+ * @brief      rpc crc16 ccitt
+ * -----------------------------------------------
+ */
+static uint16_t shell_rpc_crc(const uint8_t *data, uint16_t length)
+{
+    uint16_t crc = 0xFFFF;
+
+    while(length--) {
+        crc ^= (uint16_t)(*data++) << 8;
+        for(uint8_t i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      rpc reply
+ * @details    output is already at reply + SHELL_RPC_REPLY_HEAD
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * @param[in]  reply : reply frame start
+ * @param[in]  status: reply status
+ * @param[in]  ret   : cmd return value
+ * @param[in]  index : cmd index
+ * @param[in]  output: captured output length
+ * -----------------------------------------------
+ */
+static void shell_rpc_reply(shell_t *shell, uint8_t *reply, uint8_t status,
+                            int ret, uint16_t index, uint16_t output)
+{
+    uint16_t length = SHELL_RPC_REPLY_HEAD - SHELL_RPC_HEAD + output;
+    uint16_t crc;
+
+    reply[0] = SHELL_RPC_SYNC;
+    reply[1] = length;
+    reply[2] = length >> 8;
+    reply[3] = status;
+    for(uint8_t i = 0; i < 4; i++) {
+        reply[4 + i] = (uint32_t)ret >> (i * 8);
+    }
+    reply[8] = index;
+    reply[9] = index >> 8;
+    crc = shell_rpc_crc(reply + 1, length + 2);
+    reply[SHELL_RPC_HEAD + length] = crc;
+    reply[SHELL_RPC_HEAD + length + 1] = crc >> 8;
+    shell_write_flush(shell);
+    shell->write((char *)reply, SHELL_RPC_HEAD + length + SHELL_RPC_CRC);
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      rpc call cmd
+ * -----------------------------------------------
+ * @param[in]  shell  : shell struct
+ * @param[in]  command: cmd to call
+ * @param[in]  body   : args, argc(1) | args
+ * @param[in]  end    : args end
+ * @param[out] ret    : cmd return value
+ * @return     reply status
+ * -----------------------------------------------
+ */
+static uint8_t shell_rpc_call(shell_t *shell, shell_cmd_t *command,
+                              uint8_t *body, uint8_t *end, int *ret)
+{
+    size_t params[SHELL_PARAMETER_MAX_NUMBER] = {0};
+    char *argv[SHELL_PARAMETER_MAX_NUMBER];
+    uint8_t argc;
+
+    if(body >= end || *body >= SHELL_PARAMETER_MAX_NUMBER) {
+        return SHELL_RPC_ERROR_ARGS;
+    }
+    argc = *body++;
+    argv[0] = (char *)shell_get_command_name(command);
+    for(uint8_t i = 0; i < argc; i++) {
+        if(body + 1 >= end) {
+            return SHELL_RPC_ERROR_ARGS;
+        }
+        if(*body == 'i' && body + 5 <= end) {
+            params[i] = (size_t)(int32_t)(body[1] | (body[2] << 8) |
+                                          (body[3] << 16) | ((uint32_t)body[4] << 24));
+            argv[i + 1] = NULL;
+            body += 5;
+        } else if(*body == 's' && body[1] && body + 2 + body[1] <= end &&
+                  body[1 + body[1]] == 0)
+        {
+            argv[i + 1] = (char *)body + 2;
+            params[i] = (size_t)argv[i + 1];
+            body += 2 + body[1];
+        } else {
+            return SHELL_RPC_ERROR_ARGS;
+        }
+    }
+
+    if(command->attr.para.type == SHELL_TYPE_CMD_MAIN) {
+        int (*func)(int, char **) = command->data.cmd.function;
+        char number[SHELL_PARAMETER_MAX_NUMBER][12];
+        for(uint8_t i = 1; i <= argc; i++) {
+            if(argv[i] == NULL && command->attr.para.typed) {
+                /*! typed thunk parses it back */
+                argv[i] = &number[i][11 - shell_to_dec((int)params[i - 1], number[i])];
+            } else if(argv[i] == NULL) {
+                return SHELL_RPC_ERROR_ARGS;
+            }
+        }
+        SHELL_STATS_START();
+        *ret = func(argc + 1, argv);
+        SHELL_STATS_STOP(command);
+    } else {
+        SHELL_STATS_START();
+        *ret = shell_register_call(command, params,
+                                   command->attr.para.param_num > argc ?
+                                   command->attr.para.param_num : argc);
+        SHELL_STATS_STOP(command);
+    }
+    return SHELL_RPC_OK;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      rpc exec frame
+ * @details    cmd output is captured into the reply
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * -----------------------------------------------
+ */
+static void shell_rpc_exec(shell_t *shell)
+{
+    uint8_t *frame = shell->rpc.buffer;
+    uint16_t length = frame[1] | (frame[2] << 8);
+    uint8_t *body = frame + SHELL_RPC_HEAD + 1;
+    uint8_t *end = frame + SHELL_RPC_HEAD + length;
+    uint8_t *reply = frame + shell->rpc.expect;
+    shell_cmd_t *command = NULL;
+    char *line = NULL;
+    uint16_t index = 0xFFFF;
+    uint8_t status = SHELL_RPC_OK;
+    int ret = 0;
+    shell_output_save_t save;
+    uint16_t captured = 0;
+
+    if(shell_rpc_crc(frame + 1, length + 2) !=
+       (end[0] | (end[1] << 8)))
+    {
+        status = SHELL_RPC_ERROR_CRC;
+    } else if(length == 0) {
+        status = SHELL_RPC_ERROR_OP;
+    } else if(frame[SHELL_RPC_HEAD] == SHELL_RPC_OP_EXIT) {
+        shell->rpc.active = 0;
+    } else if(frame[SHELL_RPC_HEAD] == SHELL_RPC_OP_INDEX && body + 2 <= end) {
+        index = body[0] | (body[1] << 8);
+        body += 2;
+        if(index < shell->command_list.count) {
+            command = (shell_cmd_t *)shell->command_list.base + index;
+            if(!SHELL_CMD_VISIBLE(shell, command)) {
+                command = NULL;
+            }
+        }
+    } else if(frame[SHELL_RPC_HEAD] == SHELL_RPC_OP_NAME && body < end &&
+              body[0] && body + 1 + body[0] <= end && body[body[0]] == 0)
+    {
+        command = shell_seek_cmd(shell, (char *)body + 1,
+                                 shell->command_list.base, 0);
+        body += 1 + body[0];
+    } else if(frame[SHELL_RPC_HEAD] == SHELL_RPC_OP_LINE && body < end &&
+              body[0] && body + 1 + body[0] <= end && body[body[0]] == 0)
+    {
+        line = (char *)body + 1;
+    } else {
+        status = SHELL_RPC_ERROR_OP;
+    }
+
+    if(status == SHELL_RPC_OK && shell->rpc.active && line == NULL &&
+       (command == NULL ||
+        (command->attr.para.type != SHELL_TYPE_CMD_MAIN &&
+         command->attr.para.type != SHELL_TYPE_CMD_FUNC)))
+    {
+        status = SHELL_RPC_ERROR_NOT_FOUND;
+    }
+    if(status == SHELL_RPC_OK && shell->rpc.active) {
+        shell_capture_begin(shell, &save, (char *)reply + SHELL_RPC_REPLY_HEAD,
+                            shell->rpc.buffer + SHELL_RPC_BUFFER - SHELL_RPC_CRC -
+                            (reply + SHELL_RPC_REPLY_HEAD));
+        if(line) {
+            ret = shell_exec_sequence(shell, line, body[0] - 1, 0);
+        } else {
+            index = command - (shell_cmd_t *)shell->command_list.base;
+            shell->status.is_active = 1;
+            status = shell_rpc_call(shell, command, body, end, &ret);
+            shell->status.is_active = 0;
+        }
+        captured = shell_capture_end(shell, &save);
+    }
+    shell_rpc_reply(shell, reply, status, ret, index, captured);
+    if(!shell->rpc.active) {
+        shell_write_prompt(shell, 1);
+    }
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      rpc input
+ * @details    assemble frames from input, bytes before
+ *             sync are dropped, ctrl-c or enter there leaves
+ *             rpc mode, a frame idle for SHELL_RPC_TIMEOUT
+ *             is dropped
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * @param[in]  data  : input data
+ * @param[in]  length: input data length
+ * @return     bytes consumed
+ * -----------------------------------------------
+ */
+static uint16_t shell_rpc_input(shell_t *shell, const char *data, uint16_t length)
+{
+    uint16_t need;
+    uint16_t frame;
+
+#if SHELL_RPC_TIMEOUT > 0
+    /*! host gone mid frame */
+    if((shell->rpc.length || shell->rpc.skip) && SHELL_GET_TICK() &&
+       SHELL_GET_TICK() - shell->rpc.tick > SHELL_RPC_TIMEOUT)
+    {
+        shell->rpc.length = shell->rpc.expect = shell->rpc.skip = 0;
+    }
+    shell->rpc.tick = SHELL_GET_TICK();
+#endif /** SHELL_RPC_TIMEOUT > 0 */
+    if(shell->rpc.skip) {
+        /*! body of a refused frame, not rescanned for sync */
+        need = (shell->rpc.skip < length) ? shell->rpc.skip : length;
+        shell->rpc.skip -= need;
+        return need;
+    }
+    if(shell->rpc.length == 0 && (uint8_t)*data != SHELL_RPC_SYNC) {
+        if(*data == 0x03 || *data == '\r' || *data == '\n') {
+            /*! operator typing, not a host */
+            shell->rpc.active = 0;
+            shell_write_prompt(shell, 1);
+        }
+        return 1;
+    }
+    need = (shell->rpc.expect ? shell->rpc.expect : SHELL_RPC_HEAD) - shell->rpc.length;
+    if(need > length) {
+        need = length;
+    }
+    memcpy(shell->rpc.buffer + shell->rpc.length, data, need);
+    shell->rpc.length += need;
+
+    if(shell->rpc.expect == 0 && shell->rpc.length == SHELL_RPC_HEAD) {
+        frame = shell->rpc.buffer[1] | (shell->rpc.buffer[2] << 8);
+        shell->rpc.expect = SHELL_RPC_HEAD + frame + SHELL_RPC_CRC;
+        if(frame > SHELL_RPC_BUFFER - SHELL_RPC_HEAD - SHELL_RPC_CRC -
+                   SHELL_RPC_REPLY_HEAD - SHELL_RPC_CRC)
+        {
+            shell_rpc_reply(shell, shell->rpc.buffer, SHELL_RPC_ERROR_LENGTH,
+                            0, 0xFFFF, 0);
+            shell->rpc.skip = frame + SHELL_RPC_CRC;
+            shell->rpc.length = shell->rpc.expect = 0;
+        }
+    } else if(shell->rpc.expect && shell->rpc.length == shell->rpc.expect) {
+        shell_rpc_exec(shell);
+        shell->rpc.length = shell->rpc.expect = 0;
+    }
+    return need;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      shell rpc key
+ * @details    enter binary frame mode, replies an
+ *             empty frame as ack
+ * -----------------------------------------------
+ * @param[in]  shell : shell struct
+ * -----------------------------------------------
+ */
+void shell_rpc(shell_t *shell)
+{
+    shell->rpc.active = 1;
+    shell->rpc.length = 0;
+    shell->rpc.expect = 0;
+    shell->rpc.skip = 0;
+    shell_rpc_reply(shell, shell->rpc.buffer, SHELL_RPC_OK, 0, 0xFFFF, 0);
+}
+SHELL_EXPORT_KEY(SHELL_CMD_PERMISSION(0), SHELL_RPC_MAGIC, shell_rpc, rpc);
+#endif /** SHELL_USING_RPC == 1 */
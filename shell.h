@@ -21,6 +21,9 @@
 
 #include "shell_cfg.h"
 #include <stdint.h>
+#if SHELL_USING_LOG == 1
+#include "shell_log.h"
+#endif
 
 
 /*-----------------------------------------------------------------------------*/
@@ -62,9 +65,19 @@ enum shell_text_e {
     SHELL_TEXT_TYPE_USER,                   /**< user type */
     SHELL_TEXT_TYPE_KEY,                    /**< key type */
     SHELL_TEXT_TYPE_NONE,                   /**< none type */
+    SHELL_TEXT_INDEX_FULL,                  /**< cmd index full */
+    SHELL_TEXT_KEY_EMPTY,                   /**< key section empty */
+    SHELL_TEXT_KEY_MAP_FULL,                /**< key map full */
 };
 /*-----------------------------------------------------------------------------*/
+/*! named records, cmd, var and user share one name space */
 #define SHELL_SEC_NAME                      "shell_sec"
+/*! key records, only walked by key dispatch */
+#define SHELL_KEY_SEC_NAME                  "shell_key"
+/*! cmd names, kept together for lookup */
+#define SHELL_NAME_SEC_NAME                 "shell_name"
+/*! descriptions, only read by help and list */
+#define SHELL_DESC_SEC_NAME                 "shell_desc"
 /*-----------------------------------------------------------------------------*/
 /*! shell assert */
 #define SHELL_ASSERT(expr) \
@@ -80,10 +93,13 @@ enum shell_text_e {
 /*! attrubuted used */
 #define SHELL_USED                       __attribute__((used))
 /*-----------------------------------------------------------------------------*/
-// #define SHELL_LOCK(shell)                   shell->lock(shell)
-// #define SHELL_UNLOCK(shell)                 shell->unlock(shell)
+#if SHELL_USING_LOCK == 1
+#define SHELL_LOCK(shell)                   do { if((shell)->lock) (shell)->lock(shell); } while(0)
+#define SHELL_UNLOCK(shell)                 do { if((shell)->unlock) (shell)->unlock(shell); } while(0)
+#else
 #define SHELL_LOCK(s)
 #define SHELL_UNLOCK(s)
+#endif /** SHELL_USING_LOCK == 1 */
 /*-----------------------------------------------------------------------------*/
 /*! shell cmd authority */
 #define SHELL_CMD_PERMISSION(permission)   (permission & 0x000000FF)
@@ -100,9 +116,15 @@ enum shell_text_e {
 /*! shell cmd read only */
 #define SHELL_CMD_READ_ONLY                (1 << 14)
 
+/*! shell key value is a byte sequence string */
+#define SHELL_CMD_KEY_SEQUENCE             (1 << 15)
+
 /*! shell cmd param num */
 #define SHELL_CMD_PARAM_NUM(num)           ((num & 0x0000000F)) << 16
 
+/*! shell cmd is a typed thunk, see SHELL_EXPORT_CMD_TYPED */
+#define SHELL_CMD_TYPED                    (1 << 20)
+
 /*! shell param float */
 #define SHELL_PARAM_FLOAT(x)               (*(float *)(&x))
 /*-----------------------------------------------------------------------------*/
@@ -119,8 +141,10 @@ enum shell_text_e {
  * -----------------------------------------------
  */
 #define SHELL_EXPORT_CMD(_attr, _name, _func, _desc, ...)          \
-        const char cmd##_name[] = #_name;                     \
-        const char cmd_desc##_name[] = #_desc;                    \
+        const char cmd##_name[]                                    \
+            SHELL_SECTION(SHELL_NAME_SEC_NAME) = #_name;           \
+        const char cmd_desc##_name[]                               \
+            SHELL_SECTION(SHELL_DESC_SEC_NAME) = #_desc;           \
         SHELL_USED const shell_cmd_t                               \
         shell_cmd##_name SHELL_SECTION(SHELL_SEC_NAME) =              \
         {                                                          \
@@ -128,8 +152,164 @@ enum shell_text_e {
             .data.cmd.name = cmd##_name,                      \
             .data.cmd.function = (int (*)()) _func,                \
             .data.cmd.desc = cmd_desc##_name,                     \
-            ##__VA_ARGS__                                          \ 
+            ##__VA_ARGS__                                          \
+        }
+
+/**
+ * -----------------------------------------------
+ * @brief      shell tagged cmd define
+ * @details    C99 form of SHELL_EXPORT_CMD_TYPED, each param
+ *             is a one token tag: char, short, int, long,
+ *             int8_t ... int64_t, uint8_t ... uint64_t,
+ *             float, double, str (char *),
+ *             such as SHELL_EXPORT_CMD_TAGGED(0, pwm, pwm_set, set pwm, int, float)
+ * -----------------------------------------------
+ * @param[in]  _attr: cmd attribute, type is ignored
+ * @param[in]  _name: cmd name
+ * @param[in]  _func: cmd function, return int
+ * @param[in]  _desc: cmd description
+ * @param[in]  ...  : param tags, 1 to 8
+ * -----------------------------------------------
+ */
+#define SHELL_EXPORT_CMD_TAGGED(_attr, _name, _func, _desc, ...)   \
+        SHELL_TYPED_THUNK(_name, _func, SHELL_TAG_DECL,            \
+                          SHELL_TAG_KIND, __VA_ARGS__)             \
+        SHELL_TYPED_EXPORT(_attr, _name, _desc, __VA_ARGS__)
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+/**
+ * -----------------------------------------------
+ * @brief      shell typed cmd define
+ * @details    emit a thunk parsing each param straight into
+ *             its declared type, then call _func directly,
+ *             such as SHELL_EXPORT_CMD_TYPED(0, pwm, pwm_set, set pwm, int, float)
+ *             for `int pwm_set(int ch, float duty)`, needs C11,
+ *             see SHELL_EXPORT_CMD_TAGGED for C99
+ * -----------------------------------------------
+ * @param[in]  _attr: cmd attribute, type is ignored
+ * @param[in]  _name: cmd name
+ * @param[in]  _func: cmd function, return int
+ * @param[in]  _desc: cmd description
+ * @param[in]  ...  : param types, 1 to 8
+ * -----------------------------------------------
+ */
+#define SHELL_EXPORT_CMD_TYPED(_attr, _name, _func, _desc, ...)    \
+        SHELL_TYPED_THUNK(_name, _func, SHELL_TYPED_DECL,          \
+                          SHELL_TYPED_KIND, __VA_ARGS__)           \
+        SHELL_TYPED_EXPORT(_attr, _name, _desc, __VA_ARGS__)
+
+/*! typed param kind, or-ed with param size */
+#define SHELL_ARG_TYPE(x)  (_Generic(&(x),                         \
+        char *: SHELL_ARG_CHAR,                                    \
+        signed char *: SHELL_ARG_SIGNED,                           \
+        short *: SHELL_ARG_SIGNED,                                 \
+        int *: SHELL_ARG_SIGNED,                                   \
+        long *: SHELL_ARG_SIGNED,                                  \
+        long long *: SHELL_ARG_SIGNED,                             \
+        unsigned char *: SHELL_ARG_UNSIGNED,                       \
+        unsigned short *: SHELL_ARG_UNSIGNED,                      \
+        unsigned int *: SHELL_ARG_UNSIGNED,                        \
+        unsigned long *: SHELL_ARG_UNSIGNED,                       \
+        unsigned long long *: SHELL_ARG_UNSIGNED,                  \
+        float *: SHELL_ARG_FLOAT,                                  \
+        double *: SHELL_ARG_FLOAT,                                 \
+        char **: SHELL_ARG_STRING,                                 \
+        const char **: SHELL_ARG_STRING) | sizeof(x))
+
+#define SHELL_TYPED_DECL(t)                t
+#define SHELL_TYPED_KIND(t, x)             SHELL_ARG_TYPE(x)
+#endif /**< __STDC_VERSION__ >= 201112L */
+
+/*! tag to param type and kind, for SHELL_EXPORT_CMD_TAGGED */
+#define SHELL_TAG_DECL(t)                  SHELL_TAG_TYPE_##t
+#define SHELL_TAG_KIND(t, x)               (SHELL_TAG_KIND_##t | sizeof(x))
+#define SHELL_TAG_TYPE_char                char
+#define SHELL_TAG_TYPE_short               short
+#define SHELL_TAG_TYPE_int                 int
+#define SHELL_TAG_TYPE_long                long
+#define SHELL_TAG_TYPE_int8_t              int8_t
+#define SHELL_TAG_TYPE_int16_t             int16_t
+#define SHELL_TAG_TYPE_int32_t             int32_t
+#define SHELL_TAG_TYPE_int64_t             int64_t
+#define SHELL_TAG_TYPE_uint8_t             uint8_t
+#define SHELL_TAG_TYPE_uint16_t            uint16_t
+#define SHELL_TAG_TYPE_uint32_t            uint32_t
+#define SHELL_TAG_TYPE_uint64_t            uint64_t
+#define SHELL_TAG_TYPE_float               float
+#define SHELL_TAG_TYPE_double              double
+#define SHELL_TAG_TYPE_str                 char *
+#define SHELL_TAG_KIND_char                SHELL_ARG_CHAR
+#define SHELL_TAG_KIND_short               SHELL_ARG_SIGNED
+#define SHELL_TAG_KIND_int                 SHELL_ARG_SIGNED
+#define SHELL_TAG_KIND_long                SHELL_ARG_SIGNED
+#define SHELL_TAG_KIND_int8_t              SHELL_ARG_SIGNED
+#define SHELL_TAG_KIND_int16_t             SHELL_ARG_SIGNED
+#define SHELL_TAG_KIND_int32_t             SHELL_ARG_SIGNED
+#define SHELL_TAG_KIND_int64_t             SHELL_ARG_SIGNED
+#define SHELL_TAG_KIND_uint8_t             SHELL_ARG_UNSIGNED
+#define SHELL_TAG_KIND_uint16_t            SHELL_ARG_UNSIGNED
+#define SHELL_TAG_KIND_uint32_t            SHELL_ARG_UNSIGNED
+#define SHELL_TAG_KIND_uint64_t            SHELL_ARG_UNSIGNED
+#define SHELL_TAG_KIND_float               SHELL_ARG_FLOAT
+#define SHELL_TAG_KIND_double              SHELL_ARG_FLOAT
+#define SHELL_TAG_KIND_str                 SHELL_ARG_STRING
+
+/*! thunk declaring params by _decl(type) and parsing them by _kind(type, param) */
+#define SHELL_TYPED_THUNK(_name, _func, _decl, _kind, ...)         \
+        static int shell_thunk##_name(int argc, char *argv[])      \
+        {                                                          \
+            SHELL_TYPED_CAT(SHELL_TYPED_ARGS_,                     \
+                            SHELL_TYPED_NUM(__VA_ARGS__))(_decl, __VA_ARGS__) \
+            if(argc != SHELL_TYPED_NUM(__VA_ARGS__) + 1 ||         \
+               SHELL_TYPED_CAT(SHELL_TYPED_PARSE_,                 \
+                               SHELL_TYPED_NUM(__VA_ARGS__))(_kind, __VA_ARGS__)) \
+            {                                                      \
+                return -1;                                         \
+            }                                                      \
+            return _func(SHELL_TYPED_CAT(SHELL_TYPED_CALL_,        \
+                                         SHELL_TYPED_NUM(__VA_ARGS__))); \
         }
+
+/*! thunk exported as a main cmd */
+#define SHELL_TYPED_EXPORT(_attr, _name, _desc, ...)               \
+        SHELL_EXPORT_CMD(((_attr) & ~SHELL_CMD_TYPE(0xF)) |        \
+                         SHELL_CMD_TYPE(SHELL_TYPE_CMD_MAIN) |     \
+                         SHELL_CMD_TYPED |                         \
+                         SHELL_CMD_PARAM_NUM(SHELL_TYPED_NUM(__VA_ARGS__)), \
+                         _name, shell_thunk##_name, _desc)
+
+#define SHELL_TYPED_CAT(a, b)              SHELL_TYPED_CAT_(a, b)
+#define SHELL_TYPED_CAT_(a, b)             a##b
+#define SHELL_TYPED_NUM(...)               SHELL_TYPED_NUM_(__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define SHELL_TYPED_NUM_(_1, _2, _3, _4, _5, _6, _7, _8, n, ...) n
+#define SHELL_TYPED_ARG(k, t, n)           shell_arg_parse(argv[n], &a##n, k(t, a##n))
+
+#define SHELL_TYPED_ARGS_1(d, t1)                          d(t1) a1;
+#define SHELL_TYPED_ARGS_2(d, t1, t2)                      SHELL_TYPED_ARGS_1(d, t1) d(t2) a2;
+#define SHELL_TYPED_ARGS_3(d, t1, t2, t3)                  SHELL_TYPED_ARGS_2(d, t1, t2) d(t3) a3;
+#define SHELL_TYPED_ARGS_4(d, t1, t2, t3, t4)              SHELL_TYPED_ARGS_3(d, t1, t2, t3) d(t4) a4;
+#define SHELL_TYPED_ARGS_5(d, t1, t2, t3, t4, t5)          SHELL_TYPED_ARGS_4(d, t1, t2, t3, t4) d(t5) a5;
+#define SHELL_TYPED_ARGS_6(d, t1, t2, t3, t4, t5, t6)      SHELL_TYPED_ARGS_5(d, t1, t2, t3, t4, t5) d(t6) a6;
+#define SHELL_TYPED_ARGS_7(d, t1, t2, t3, t4, t5, t6, t7)  SHELL_TYPED_ARGS_6(d, t1, t2, t3, t4, t5, t6) d(t7) a7;
+#define SHELL_TYPED_ARGS_8(d, t1, t2, t3, t4, t5, t6, t7, t8) SHELL_TYPED_ARGS_7(d, t1, t2, t3, t4, t5, t6, t7) d(t8) a8;
+
+#define SHELL_TYPED_PARSE_1(k, t1)                         SHELL_TYPED_ARG(k, t1, 1)
+#define SHELL_TYPED_PARSE_2(k, t1, t2)                     SHELL_TYPED_PARSE_1(k, t1) || SHELL_TYPED_ARG(k, t2, 2)
+#define SHELL_TYPED_PARSE_3(k, t1, t2, t3)                 SHELL_TYPED_PARSE_2(k, t1, t2) || SHELL_TYPED_ARG(k, t3, 3)
+#define SHELL_TYPED_PARSE_4(k, t1, t2, t3, t4)             SHELL_TYPED_PARSE_3(k, t1, t2, t3) || SHELL_TYPED_ARG(k, t4, 4)
+#define SHELL_TYPED_PARSE_5(k, t1, t2, t3, t4, t5)         SHELL_TYPED_PARSE_4(k, t1, t2, t3, t4) || SHELL_TYPED_ARG(k, t5, 5)
+#define SHELL_TYPED_PARSE_6(k, t1, t2, t3, t4, t5, t6)     SHELL_TYPED_PARSE_5(k, t1, t2, t3, t4, t5) || SHELL_TYPED_ARG(k, t6, 6)
+#define SHELL_TYPED_PARSE_7(k, t1, t2, t3, t4, t5, t6, t7) SHELL_TYPED_PARSE_6(k, t1, t2, t3, t4, t5, t6) || SHELL_TYPED_ARG(k, t7, 7)
+#define SHELL_TYPED_PARSE_8(k, t1, t2, t3, t4, t5, t6, t7, t8) SHELL_TYPED_PARSE_7(k, t1, t2, t3, t4, t5, t6, t7) || SHELL_TYPED_ARG(k, t8, 8)
+
+#define SHELL_TYPED_CALL_1                 a1
+#define SHELL_TYPED_CALL_2                 SHELL_TYPED_CALL_1, a2
+#define SHELL_TYPED_CALL_3                 SHELL_TYPED_CALL_2, a3
+#define SHELL_TYPED_CALL_4                 SHELL_TYPED_CALL_3, a4
+#define SHELL_TYPED_CALL_5                 SHELL_TYPED_CALL_4, a5
+#define SHELL_TYPED_CALL_6                 SHELL_TYPED_CALL_5, a6
+#define SHELL_TYPED_CALL_7                 SHELL_TYPED_CALL_6, a7
+#define SHELL_TYPED_CALL_8                 SHELL_TYPED_CALL_7, a8
 /**
  * -----------------------------------------------
  * @brief      shell key define
@@ -141,15 +321,41 @@ enum shell_text_e {
  * -----------------------------------------------
  */
 #define SHELL_EXPORT_KEY(_attr, _value, _func, _desc)             \
-        const char cmd_desc##_value[] = #_desc;                  \
+        const char cmd_desc##_value[]                             \
+            SHELL_SECTION(SHELL_DESC_SEC_NAME) = #_desc;          \
         SHELL_USED const shell_cmd_t                              \
-        shell_key##_value SHELL_SECTION(SHELL_SEC_NAME) =             \
+        shell_key##_value SHELL_SECTION(SHELL_KEY_SEC_NAME) =     \
         {                                                         \
             .attr.value = _attr | SHELL_CMD_TYPE(SHELL_TYPE_KEY), \
             .data.key.value = _value,                             \
             .data.key.function = (void (*)(shell_t *)) _func,     \
             .data.key.desc = cmd_desc##_value                    \
         }
+/**
+ * -----------------------------------------------
+ * @brief      shell key sequence define,
+ *             for keys longer than the 4 bytes of _value
+ * -----------------------------------------------
+ * @param[in]  _attr : key attribute
+ * @param[in]  _name : key name
+ * @param[in]  _seq  : key byte sequence string, such as "\033[1;5C"
+ * @param[in]  _func : key function
+ * @param[in]  _desc : key description
+ * -----------------------------------------------
+ */
+#define SHELL_EXPORT_KEY_SEQ(_attr, _name, _seq, _func, _desc)     \
+        const char key_seq##_name[] = _seq;                        \
+        const char key_desc##_name[]                               \
+            SHELL_SECTION(SHELL_DESC_SEC_NAME) = #_desc;           \
+        SHELL_USED const shell_cmd_t                               \
+        shell_key##_name SHELL_SECTION(SHELL_KEY_SEC_NAME) =       \
+        {                                                          \
+            .attr.value = _attr | SHELL_CMD_TYPE(SHELL_TYPE_KEY) | \
+                          SHELL_CMD_KEY_SEQUENCE,                  \
+            .data.key.seq = key_seq##_name,                        \
+            .data.key.function = (void (*)(shell_t *)) _func,      \
+            .data.key.desc = key_desc##_name                       \
+        }
 /**
  * -----------------------------------------------
  * @brief      shell var define
@@ -161,8 +367,10 @@ enum shell_text_e {
  * -----------------------------------------------
  */
 #define SHELL_EXPORT_VAR(_attr, _name, _value, _desc)              \
-        const char cmd##_name[] = #_name;                     \
-        const char cmd_desc##_name[] = #_desc;                    \
+        const char cmd##_name[]                                    \
+            SHELL_SECTION(SHELL_NAME_SEC_NAME) = #_name;           \
+        const char cmd_desc##_name[]                               \
+            SHELL_SECTION(SHELL_DESC_SEC_NAME) = #_desc;           \
         SHELL_USED const shell_cmd_t                               \
         shellVar##_name SHELL_SECTION(SHELL_SEC_NAME) =            \
         {                                                          \
@@ -183,21 +391,61 @@ enum shell_text_e {
  * -----------------------------------------------
  */
 #define SHELL_EXPORT_USER(_attr, _name, _pasd, _desc)              \
-        const char cmd##_name[] = #_name;                     \
+        const char cmd##_name[]                                    \
+            SHELL_SECTION(SHELL_NAME_SEC_NAME) = #_name;           \
         const char cmd_password##_name[] = #_pasd;                \
-        const char cmd_desc##_name[] = #_desc;                    \
+        const char cmd_desc##_name[]                               \
+            SHELL_SECTION(SHELL_DESC_SEC_NAME) = #_desc;           \
         SHELL_USED const shell_cmd_t                               \
         shell_user##_name SHELL_SECTION(SHELL_SEC_NAME) =          \
         {                                                          \
             .attr.value = _attr | SHELL_CMD_TYPE(SHELL_TYPE_USER), \
             .data.user.name = cmd##_name,                     \
-            .data.user.password = cmd_password##_name,            \
+            .data.user.pasd = cmd_password##_name,                \
             .data.user.desc = cmd_desc##_name                     \
         }
 
+/**
+ * -----------------------------------------------
+ * @brief      shell cmd record for shell_register_dynamic,
+ *             kept out of section by the caller, such as
+ *             static const shell_cmd_t diag = SHELL_CMD_INIT(0, diag, diag_run, run diag);
+ * -----------------------------------------------
+ * @param[in]  _attr: cmd attribute
+ * @param[in]  _name: cmd name
+ * @param[in]  _func: cmd function
+ * @param[in]  _desc: cmd description
+ * -----------------------------------------------
+ */
+#define SHELL_CMD_INIT(_attr, _name, _func, _desc)                 \
+        {                                                          \
+            .attr.value = _attr,                                   \
+            .data.cmd.name = #_name,                               \
+            .data.cmd.function = (int (*)()) _func,                \
+            .data.cmd.desc = #_desc                                \
+        }
+
+/**
+ * -----------------------------------------------
+ * @brief      shell key record for shell_register_dynamic
+ * -----------------------------------------------
+ * @param[in]  _attr : key attribute
+ * @param[in]  _value: key value
+ * @param[in]  _func : key function
+ * @param[in]  _desc : key description
+ * -----------------------------------------------
+ */
+#define SHELL_KEY_INIT(_attr, _value, _func, _desc)                \
+        {                                                          \
+            .attr.value = _attr | SHELL_CMD_TYPE(SHELL_TYPE_KEY),  \
+            .data.key.value = _value,                              \
+            .data.key.function = (void (*)(shell_t *)) _func,      \
+            .data.key.desc = #_desc                                \
+        }
+
 /*-----------------------------------------------------------------------------*/
 /*! shell define struct */
-typedef struct {
+typedef struct shell_def {
 
     /*! shell info */
     struct {
@@ -213,27 +461,83 @@ typedef struct {
     struct {
         uint16_t length;                          /**< input length */
         uint16_t cursor;                          /**< current cursor */
-        char *buffer;                             /**< input buffer */
+        char *buffer;                             /**< input gap buffer, text after cursor at end */
         char *param[SHELL_PARAMETER_MAX_NUMBER];  /**< param */
         uint16_t buffer_size;                     /**< input buffer size */
         uint16_t param_count;                     /**< parameter number */
         int key_value;                            /**< input key value */
+        uint8_t key_state;                        /**< key map state, or sequence bytes matched */
+        const char *key_seq;                      /**< sequence half typed, linear match */
     } parser;
 
-    /*! shell history cmds */
+#if SHELL_HISTORY_MAX_NUMBER > 0
+    /*! shell history cmds, packed ring of `length | cmd | length` */
     struct {
-        char *item[SHELL_HISTORY_MAX_NUMBER];     /**< history cmds */
+        uint16_t head;                            /**< next entry position */
+        uint16_t tail;                            /**< oldest entry position */
+        uint16_t used;                            /**< used bytes */
         uint16_t number;                          /**< history cmds number */
-        uint16_t record;                          /**< current history record */
-        signed short offset;                      /**< current history offset */
+        uint16_t record;                          /**< shown entry position */
+        uint16_t offset;                          /**< shown entry age, 0 for new line */
+        char *buffer;                             /**< history arena, set before shell_init, NULL for buffer tail */
+        uint16_t size;                            /**< history arena size */
+#if SHELL_HISTORY_PERSIST == 1
+        uint32_t log;                             /**< log end offset, 0 if log not valid */
+#endif /** SHELL_HISTORY_PERSIST == 1 */
+#if SHELL_HISTORY_SEARCH == 1
+        struct {
+            uint16_t pos;                         /**< entry position */
+            uint32_t mask;                        /**< chars in entry, bit (char & 0x1F) */
+        } index[SHELL_HISTORY_MAX_NUMBER];        /**< entries from oldest, ring from first */
+        uint16_t first;                           /**< index slot of oldest entry */
+        uint16_t match;                           /**< matched entry age, 0 if none */
+        uint8_t search;                           /**< reverse search active */
+        uint8_t pattern_length;                   /**< search pattern length */
+        char pattern[SHELL_HISTORY_SEARCH_LENGTH];/**< search pattern */
+#endif /** SHELL_HISTORY_SEARCH == 1 */
     } history;
+#endif /** SHELL_HISTORY_MAX_NUMBER > 0 */
 
     /*! shell command list */
     struct {
         void *base;                               /**< cmd list base addr */
         uint16_t count;                           /**< cmd num */
     } command_list;
+
+    /*! shell key list */
+    struct {
+        void *base;                               /**< key list base addr */
+        uint16_t count;                           /**< key num */
+    } key_list;
     
+    /*! shell output staging */
+    struct {
+        char *buffer;                             /**< staging buffer */
+        uint16_t size;                            /**< staging buffer size */
+        uint16_t length;                          /**< staged length */
+        uint8_t hold;                             /**< staging depth, write through if 0 */
+        uint8_t capture;                          /**< keep output in buffer, never write */
+#if SHELL_OUTPUT_BUFFER > 0
+        char data[SHELL_OUTPUT_BUFFER];           /**< default staging buffer */
+#endif
+    } output;
+
+#if SHELL_USING_LOG == 1
+    shell_log_t *log;                             /**< log queue drained by shell task, NULL if none */
+#endif
+
+#if SHELL_USING_RPC == 1
+    /*! shell rpc frame */
+    struct {
+        uint8_t active;                           /**< binary frame mode */
+        uint16_t length;                          /**< received length */
+        uint16_t expect;                          /**< frame length, 0 if header incomplete */
+        uint16_t skip;                            /**< bytes left of a refused frame */
+        uint32_t tick;                            /**< tick of last frame byte */
+        uint8_t buffer[SHELL_RPC_BUFFER];         /**< request, then reply & captured output */
+    } rpc;
+#endif /** SHELL_USING_RPC == 1 */
+
     /*! shell status */
     struct {
         uint8_t is_checked : 1;             /**< password checked */
@@ -245,9 +549,26 @@ typedef struct {
     signed short (*read)(char *, uint16_t);      /**< shell read function */
     signed short (*write)(char *, uint16_t);     /**< shell write function */
 
-    /*! shell lock & unlock function */
-    // int (*lock)(struct shell_def *);         /**< shell 加锁 */
-    // int (*unlock)(struct shell_def *);       /**< shell 解锁 */
+#if SHELL_HISTORY_MAX_NUMBER > 0 && SHELL_HISTORY_PERSIST == 1
+    /*! shell history log storage, set before shell_init, NULL if none */
+    signed short (*history_read)(uint32_t, char *, uint16_t);        /**< read log at offset */
+    signed short (*history_write)(uint32_t, const char *, uint16_t); /**< write log at offset, 0 starts over */
+#endif
+
+#if SHELL_USING_VISIBLE_MAP == 1
+    /*! bit per cmd/var/user & key visible to current user, set on user
+        switch, row 0 for unchecked session, row 1 for checked */
+    struct {
+        uint32_t cmd[2][(SHELL_VISIBLE_MAP_MAX + 31) / 32];  /**< bit of command_list item */
+        uint32_t key[2][(SHELL_VISIBLE_KEY_MAX + 31) / 32];  /**< bit of key_list item */
+    } visible;
+#endif /** SHELL_USING_VISIBLE_MAP == 1 */
+
+#if SHELL_USING_LOCK == 1
+    /*! shell lock & unlock function, recursive, NULL if single task */
+    int (*lock)(struct shell_def *);             /**< shell lock */
+    int (*unlock)(struct shell_def *);           /**< shell unlock */
+#endif /** SHELL_USING_LOCK == 1 */
 } shell_t;
 
 /*! shell command define struct */
@@ -260,8 +581,9 @@ typedef struct shell_command {
             uint8_t enable_unchecked : 1;    /**< enable with unchecked */
             uint8_t disable_return : 1;      /**< disable return value */
             uint8_t read_only : 1;           /**< read only */
-            uint8_t reserve : 1;             /**< reserve */
+            uint8_t sequence : 1;            /**< key value is sequence */
             uint8_t param_num : 4;           /**< parameter number */
+            uint8_t typed : 1;               /**< typed thunk */
         } para;
 
         int value;
@@ -291,7 +613,10 @@ typedef struct shell_command {
 
         /*! shell key define */
         struct {
-            int value;                      /**< key value */
+            union {
+                int value;                  /**< key value */
+                const char *seq;            /**< key sequence */
+            };
             void (*function)(shell_t *);    /**< key execute function */
             const char *desc;               /**< key description */
         } key;                           
@@ -305,6 +630,17 @@ typedef struct {
     int (*get)(); /**< 变量get方法 */
     int (*set)(); /**< 变量set方法 */
 } shell_node_var_attr_t;
+
+#if SHELL_USING_CMD_HASH == 1
+/*! shell cmd perfect hash, generated by tools/shell_cmd_hash.py */
+typedef struct {
+    uint32_t seed;                          /**< name hash seed */
+    uint16_t count;                         /**< slot num, equal to cmd/var/user num */
+    uint16_t bucket_count;                  /**< displacement num */
+    const uint16_t *disp;                   /**< displacement of bucket */
+    const shell_cmd_t *const *slot;         /**< cmd of slot */
+} shell_cmd_hash_t;
+#endif /** SHELL_USING_CMD_HASH == 1 */
 /*-----------------------------------------------------------------------------*/
 void shell_init(shell_t *shell, char *buffer, uint16_t size);
 
@@ -312,18 +648,30 @@ void shell_remove(shell_t *shell);
 
 uint16_t shell_write_string(shell_t *shell, const char *string);
 
+void shell_write_flush(shell_t *shell);
+
 void shell_print(shell_t *shell, const char *fmt, ...);
 
 void shell_scan(shell_t *shell, char *fmt, ...);
 
 void shell_handler(shell_t *shell, char data);
 
+void shell_handler_block(shell_t *shell, const char *data, uint16_t length);
+
 void shell_write_end_line(shell_t *shell, char *buffer, int len);
 
+#if SHELL_USING_LOG == 1
+void shell_write_log(shell_t *shell);
+#endif
+
 void shell_task(void *param);
 
 int shell_run(shell_t *shell, const char *cmd);
 
+#if SHELL_CAPTURE_LINE_MAX > 0
+int shell_run_capture(shell_t *shell, const char *cmd, char *buffer, uint16_t size, int *ret);
+#endif /** SHELL_CAPTURE_LINE_MAX > 0 */
+
 shell_t *shell_get_current(void);
 
 int shell_get_var_value(shell_t *shell, shell_cmd_t *command);
@@ -333,25 +681,32 @@ shell_cmd_t *shell_seek_cmd(shell_t *shell,
                             shell_cmd_t *base,
                             uint16_t compare_length);
 
+#if SHELL_USING_DYNAMIC == 1
+int shell_register_dynamic(const shell_cmd_t *command);
+
+int shell_unregister(const shell_cmd_t *command);
+#endif /** SHELL_USING_DYNAMIC == 1 */
+
 /*-----------------------------------------------------------------------------*/
 /*-----------------------------------------------------------------------------*/                            
 /*------------------------------- shell register -----------------------------*/                            
 /*-----------------------------------------------------------------------------*/                            
 /*-----------------------------------------------------------------------------*/                            
+int shell_register_run(shell_t *shell, shell_cmd_t *command, int argc, char *argv[]);
+
 /**
  * ---------------------------------------
- *  number type
+ *  typed param kind, see SHELL_ARG_TYPE
  * ---------------------------------------
  */
-typedef enum shell_num_type_e
-{
-    NUM_TYPE_DEC,                      /**< decimal */
-    NUM_TYPE_BIN,                      /**< binary */
-    NUM_TYPE_OCT,                      /**< octal */
-    NUM_TYPE_HEX,                      /**< hex */
-    NUM_TYPE_FLOAT                     /**< float */
-} SHELL_NUM_TYPE_E;
+enum shell_arg_kind_e {
+    SHELL_ARG_CHAR = 0x10,             /**< char, 'c' or number */
+    SHELL_ARG_SIGNED = 0x20,           /**< signed integer */
+    SHELL_ARG_UNSIGNED = 0x30,         /**< unsigned integer */
+    SHELL_ARG_FLOAT = 0x40,            /**< float or double */
+    SHELL_ARG_STRING = 0x50,           /**< string */
+};
 
-int shell_register_run(shell_t *shell, shell_cmd_t *command, int argc, char *argv[]);
+int shell_arg_parse(char *string, void *value, uint8_t type);
 
 #endif/**< __SHELL_H__ */
@@ -41,12 +41,28 @@
 
 #define  SHELL_PARAMETER_MAX_NUMBER            8           /**< max number of shell parameter */
 
-#define  SHELL_HISTORY_MAX_NUMBER              5           /**< max number of shell history */
+#define  SHELL_HISTORY_MAX_NUMBER              32          /**< max number of shell history, 0 to disable */
+
+#define  SHELL_HISTORY_BUFFER                  512         /**< shell history arena size, entries take length + 4, see shell history buffer */
+
+#define  SHELL_HISTORY_SEARCH                  1           /**< whether to support ctrl-r reverse history search */
+
+#define  SHELL_HISTORY_SEARCH_LENGTH           32          /**< max length of reverse search pattern */
+
+#ifndef  SHELL_HISTORY_PERSIST
+#define  SHELL_HISTORY_PERSIST                 0           /**< whether to keep history in a log, set shell history_read & history_write, board linker script needs the log section */
+#endif
+
+#define  SHELL_HISTORY_LOG_SIZE                2048        /**< max history log size, compacted to arena entries when full */
 
 #define  SHELL_SUPPORT_END_LINE                0           /**< whether to support end line */
 
+#define  SHELL_SUPPORT_CMD_SEQUENCE            1           /**< whether to support cmd sequence in one line, `a; b && c` */
+
 #define  SHELL_TASK_WHILE                      1           /**< whether to use default shell task while loop */
 
+#define  SHELL_TASK_READ_SIZE                  32          /**< max bytes read from port per shell task loop */
+
 #define  SHELL_DOUBLE_CLICK_TIME               200         /**< double click time(ms), used in SHELL_LONG_HELP, double click tab to complete help */
 
 #define  SHELL_QUICK_HELP                      1           /**< whether to use quick help, double click tab to show cmd info */
@@ -55,14 +71,80 @@
 
 #define  SHELL_PRINT_BUFFER                    128         /**< shell formatted output buffer size */
 
+#define  SHELL_OUTPUT_BUFFER                   64          /**< shell output staging buffer size, 0 to write through */
+
 #define  SHELL_SCAN_BUFFER                     0           /**< shell formatted input buffer size */
 
-#define  SHELL_USING_LOCK                      0           /**< whether to use shell lock */
+#define  SHELL_CAPTURE_LINE_MAX                128         /**< max cmd line of shell_run_capture, kept on stack, 0 to disable */
+
+#ifndef  SHELL_USING_LOG
+#define  SHELL_USING_LOG                       0           /**< whether to drain a log queue in shell task, set shell log, see shell_log.h */
+#endif
+
+#define  SHELL_LOG_QUEUE_SIZE                  16          /**< log records in queue, power of 2 */
+
+#define  SHELL_LOG_RECORD_SIZE                 64          /**< max bytes of one log record */
+
+#define  SHELL_LOG_SOURCE_MAX                  8           /**< log producers with own rate limit and drop count */
+
+#define  SHELL_LOG_RATE                        20          /**< log records per second of each source, 0 no limit, needs SHELL_GET_TICK */
+
+#define  SHELL_LOG_BURST                       8           /**< log records a source may push at once */
+
+#ifndef  SHELL_USING_LOCK
+#define  SHELL_USING_LOCK                      0           /**< whether to use shell lock, set shell lock & unlock to a recursive mutex */
+#endif
 
 #define  SHELL_CLS_WHEN_LOGIN                  1           /**< whether to clear screen when login */
 
 #define  SHELL_LOCK_TIMEOUT               (0 * 60 * 1000)  /**< shell lock timeout(ms), used in double click tab */
 
+#define  SHELL_USING_CMD_INDEX                 1           /**< whether to build sorted name index for cmd lookup */
+
+#ifndef  SHELL_CMD_INDEX_MAX
+#define  SHELL_CMD_INDEX_MAX                   256         /**< max number of indexed cmd/var/user, size to the section, linear seek & warning if exceeded */
+#endif
+
+#define  SHELL_USING_CMD_HASH                  1           /**< whether to seek cmd by perfect hash table of tools/shell_cmd_hash.py when linked */
+
+#define  SHELL_USING_VISIBLE_MAP               1           /**< whether to keep bitmap of cmd & key visible to current user, built on user switch */
+
+#define  SHELL_VISIBLE_MAP_MAX                 256         /**< max number of cmd/var/user with visible bit, check permission per item beyond */
+
+#define  SHELL_VISIBLE_KEY_MAX                 64          /**< max number of key with visible bit, check permission per item beyond */
+
+#define  SHELL_USING_DYNAMIC                   1           /**< whether cmd/var/user & key may be registered at runtime, see shell_register_dynamic */
+
+#define  SHELL_DYNAMIC_MAX                     16          /**< max number of cmd/var/user registered at runtime */
+
+#define  SHELL_DYNAMIC_KEY_MAX                 4           /**< max number of key registered at runtime */
+
+#define  SHELL_USING_KEY_MAP                   1           /**< whether to compile keys into a state machine for input dispatch */
+
+#define  SHELL_KEY_MAP_MAX                     32          /**< max number of key map transitions, fallback to linear match if exceeded */
+
+#define  SHELL_USING_CMD_STATS                 0           /**< whether to record cmd execution time, see SHELL_GET_HRTICK */
+
+#define  SHELL_CMD_STATS_MAX                   16          /**< max number of cmd with execution stats */
+
+#define  SHELL_CMD_STATS_BUCKETS               16          /**< execution time log2 histogram bucket num */
+
+#define  SHELL_USING_RPC                       0           /**< whether to support binary frame mode, see shell_rpc_input */
+
+#define  SHELL_RPC_BUFFER                      256         /**< rpc frame buffer size, holds request, reply and captured output */
+
+#define  SHELL_RPC_MAGIC                       0x1B5B5250  /**< key value to enter rpc mode, ESC [ R P */
+
+#define  SHELL_RPC_TIMEOUT                     500         /**< ms between bytes of a frame before it is dropped, 0 never, needs SHELL_GET_TICK */
+
+#ifndef  SHELL_SECTION_BOUNDS
+#if defined(__linux__)
+#define  SHELL_SECTION_BOUNDS                  1           /**< linux host, gnu ld bounds */
+#else
+#define  SHELL_SECTION_BOUNDS                  0           /**< section bounds symbols, 0 `shell_sec$$Base`/`$$Limit`, 1 gnu ld `__start_shell_sec`/`__stop_shell_sec`, 2 linker script `_shell_command_start`/`_end` */
+#endif
+#endif
+
 
 #ifndef SHELL_GET_TICK
 /**
@@ -73,5 +155,14 @@
 #define     SHELL_GET_TICK()                   0
 #endif /** SHELL_GET_TICK */
 
+#ifndef SHELL_GET_HRTICK
+/**
+ * @brief get high resolution tick
+ *        define this macro to get a free running 32 bits counter, such as `DWT->CYCCNT`
+ * @note used by SHELL_USING_CMD_STATS, cmd execution time is recorded in this tick
+ */
+#define     SHELL_GET_HRTICK()                 0
+#endif /** SHELL_GET_HRTICK */
+
 
 #endif
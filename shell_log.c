@@ -0,0 +1,262 @@
+/**
+ * ********************************************************
+ * \file      shell_log.c
+ * \brief     shell log queue realize
+ * \version   1.0
+ * \author    Awesome
+ * \copyright (c) 2026, Awesome
+ * ********************************************************
+ * \note      revision note
+ * |   Date    |  version  |  author   | Description
+ * |2026-10-18 |    1.0    |  Awesome  | init version
+ * ********************************************************
+ * \note      bounded queue of fixed records, a producer claims
+ *            a record by moving tail with compare and swap and
+ *            publishes it by its sequence, no producer waits on
+ *            another, so tasks and isr may push at any time
+ * ********************************************************
+ */
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "shell_log.h"
+
+#define SHELL_LOG_MASK                     (SHELL_LOG_QUEUE_SIZE - 1)
+
+#define SHELL_LOG_LOAD(x)                  __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define SHELL_LOG_STORE(x, v)              __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+
+#if (SHELL_LOG_QUEUE_SIZE & SHELL_LOG_MASK) != 0
+#error "SHELL_LOG_QUEUE_SIZE must be power of 2"
+#endif
+
+/**
+ * -----------------------------------------------
+ * @brief      init log
+ * -----------------------------------------------
+ * @param[in]  log : log obj, notify is kept
+ * -----------------------------------------------
+ */
+void shell_log_init(shell_log_t *log)
+{
+    for(uint32_t i = 0; i < SHELL_LOG_QUEUE_SIZE; i++) {
+        log->record[i].sequence = i;
+    }
+    for(uint8_t i = 0; i < SHELL_LOG_SOURCE_MAX; i++) {
+        log->source[i].tick = 0;
+        log->source[i].tokens = SHELL_LOG_BURST;
+        log->source[i].dropped = 0;
+        log->source[i].reported = 0;
+    }
+    log->head = 0;
+    log->tail = 0;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      take a token of source
+ * @details    token bucket of SHELL_LOG_RATE records per
+ *             second, up to SHELL_LOG_BURST at once, no
+ *             limit while SHELL_GET_TICK is not defined
+ * -----------------------------------------------
+ * @param[in]  source : log source
+ * @return     1 may push, 0 over rate
+ * -----------------------------------------------
+ */
+static int shell_log_take(shell_log_source_t *source)
+{
+#if SHELL_LOG_RATE > 0
+    uint32_t now = SHELL_GET_TICK();
+    uint32_t elapsed;
+    uint32_t add;
+
+    if(!now) {
+        return 1;
+    }
+    elapsed = now - source->tick;
+    if(elapsed >= 1000UL * SHELL_LOG_BURST / SHELL_LOG_RATE + 1) {
+        source->tokens = SHELL_LOG_BURST;
+        source->tick = now;
+    } else if((add = elapsed * SHELL_LOG_RATE / 1000) > 0) {
+        source->tokens = (source->tokens + add > SHELL_LOG_BURST) ?
+                         SHELL_LOG_BURST : source->tokens + add;
+        /*! keep the part of a token not yet earned */
+        source->tick += add * 1000 / SHELL_LOG_RATE;
+    }
+    if(source->tokens == 0) {
+        return 0;
+    }
+    source->tokens--;
+#else
+    (void)source;
+#endif /** SHELL_LOG_RATE > 0 */
+    return 1;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      write log record
+ * @details    data beyond SHELL_LOG_RECORD_SIZE is cut,
+ *             a dropped record is counted to its source
+ * -----------------------------------------------
+ * @param[in]  log    : log obj
+ * @param[in]  source : source id of caller task or isr
+ * @param[in]  data   : log data
+ * @param[in]  length : data length
+ * @return     0 queued, -1 dropped
+ * -----------------------------------------------
+ */
+int shell_log_write(shell_log_t *log, uint8_t source, const char *data, uint16_t length)
+{
+    shell_log_source_t *src = &log->source[source % SHELL_LOG_SOURCE_MAX];
+    shell_log_record_t *record;
+    uint32_t pos;
+    int32_t diff;
+
+    if(!shell_log_take(src)) {
+        SHELL_LOG_STORE(src->dropped, src->dropped + 1);
+        return -1;
+    }
+    pos = __atomic_load_n(&log->tail, __ATOMIC_RELAXED);
+    for(;;) {
+        record = &log->record[pos & SHELL_LOG_MASK];
+        diff = (int32_t)(SHELL_LOG_LOAD(record->sequence) - pos);
+        if(diff == 0) {
+            if(__atomic_compare_exchange_n(&log->tail, &pos, pos + 1, 1,
+                                           __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        } else if(diff < 0) {
+            /*! consumer has not freed this record, queue full */
+            SHELL_LOG_STORE(src->dropped, src->dropped + 1);
+            return -1;
+        } else {
+            pos = __atomic_load_n(&log->tail, __ATOMIC_RELAXED);
+        }
+    }
+    if(length > SHELL_LOG_RECORD_SIZE) {
+        length = SHELL_LOG_RECORD_SIZE;
+    }
+    memcpy(record->data, data, length);
+    record->length = length;
+    SHELL_LOG_STORE(record->sequence, pos + 1);
+    if(log->notify) {
+        log->notify();
+    }
+    return 0;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      print log record
+ * @details    a line cut to the record keeps the line end
+ *             of fmt, so the next record starts a line
+ * -----------------------------------------------
+ * @param[in]  log    : log obj
+ * @param[in]  source : source id of caller task or isr
+ * @param[in]  fmt    : format string
+ * @return     0 queued, -1 dropped
+ * -----------------------------------------------
+ */
+int shell_log_print(shell_log_t *log, uint8_t source, const char *fmt, ...)
+{
+    char buffer[SHELL_LOG_RECORD_SIZE];
+    va_list vargs;
+    size_t end;
+    int len;
+
+    va_start(vargs, fmt);
+    len = vsnprintf(buffer, SHELL_LOG_RECORD_SIZE, fmt, vargs);
+    va_end(vargs);
+    if(len < 0) {
+        return -1;
+    }
+    if(len > SHELL_LOG_RECORD_SIZE - 1) {
+        /*! vsnprintf keeps size - 1 chars and a terminator */
+        len = SHELL_LOG_RECORD_SIZE - 1;
+        end = strlen(fmt);
+        if(end >= 1 && fmt[end - 1] == '\n') {
+            end = (end >= 2 && fmt[end - 2] == '\r') ? 2 : 1;
+            memcpy(buffer + len - end, "\r\n" + 2 - end, end);
+        }
+    }
+    return shell_log_write(log, source, buffer, len);
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      peek the oldest log record, consumer only
+ * -----------------------------------------------
+ * @param[in]  log  : log obj
+ * @param[out] data : record data
+ * @return     record length, 0 if none is ready
+ * -----------------------------------------------
+ */
+uint16_t shell_log_peek(shell_log_t *log, const char **data)
+{
+    shell_log_record_t *record = &log->record[log->head & SHELL_LOG_MASK];
+
+    if(SHELL_LOG_LOAD(record->sequence) != log->head + 1) {
+        return 0;
+    }
+    *data = record->data;
+    return record->length;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      free the peeked record, consumer only
+ * -----------------------------------------------
+ * @param[in]  log : log obj
+ * -----------------------------------------------
+ */
+void shell_log_skip(shell_log_t *log)
+{
+    shell_log_record_t *record = &log->record[log->head & SHELL_LOG_MASK];
+
+    SHELL_LOG_STORE(record->sequence, log->head + SHELL_LOG_QUEUE_SIZE);
+    log->head++;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      take dropped count of source, consumer only
+ * -----------------------------------------------
+ * @param[in]  log    : log obj
+ * @param[in]  source : source id
+ * @return     records dropped since last call
+ * -----------------------------------------------
+ */
+uint32_t shell_log_dropped(shell_log_t *log, uint8_t source)
+{
+    shell_log_source_t *src = &log->source[source % SHELL_LOG_SOURCE_MAX];
+    uint32_t dropped = SHELL_LOG_LOAD(src->dropped);
+    uint32_t count = dropped - src->reported;
+
+    src->reported = dropped;
+    return count;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      whether log has record or drop to write
+ * -----------------------------------------------
+ * @param[in]  log : log obj
+ * @return     1 pending, 0 none
+ * -----------------------------------------------
+ */
+int shell_log_pending(shell_log_t *log)
+{
+    const char *data;
+
+    if(shell_log_peek(log, &data)) {
+        return 1;
+    }
+    for(uint8_t i = 0; i < SHELL_LOG_SOURCE_MAX; i++) {
+        if(SHELL_LOG_LOAD(log->source[i].dropped) != log->source[i].reported) {
+            return 1;
+        }
+    }
+    return 0;
+}
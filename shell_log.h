@@ -0,0 +1,61 @@
+/**
+ * ********************************************************
+ * \file      shell_log.h
+ * \brief     shell log queue, many producers & one consumer
+ * \version   1.0
+ * \author    Awesome
+ * \copyright (c) 2026, Awesome
+ * ********************************************************
+ * \note      revision note
+ * |   Date    |  version  |  author   | Description
+ * |2026-10-18 |    1.0    |  Awesome  | init version
+ * ********************************************************
+ */
+
+#ifndef __SHELL_LOG_H__
+#define __SHELL_LOG_H__
+
+#include <stdint.h>
+#include "shell_cfg.h"
+
+/*-----------------------------------------------------------------------------*/
+/*! log record, sequence tells which lap of the queue owns it */
+typedef struct {
+    uint32_t sequence;                     /**< free at index, ready at index + 1 */
+    uint16_t length;                       /**< data length */
+    char data[SHELL_LOG_RECORD_SIZE];      /**< formatted log line */
+} shell_log_record_t;
+
+/*! log producer, each task or isr uses its own source */
+typedef struct {
+    uint32_t tick;                         /**< last refill tick */
+    uint16_t tokens;                       /**< records can be pushed now */
+    uint32_t dropped;                      /**< records dropped by rate or full queue */
+    uint32_t reported;                     /**< dropped records reported, owned by consumer */
+} shell_log_source_t;
+
+/*! shell log struct */
+typedef struct {
+    shell_log_record_t record[SHELL_LOG_QUEUE_SIZE]; /**< records, power of 2 */
+    shell_log_source_t source[SHELL_LOG_SOURCE_MAX]; /**< producers */
+    uint32_t head;                         /**< read index, owned by consumer */
+    uint32_t tail;                         /**< write index, claimed by producers */
+    void (*notify)(void);                  /**< wake consumer after push, NULL if polled */
+} shell_log_t;
+
+/*-----------------------------------------------------------------------------*/
+void shell_log_init(shell_log_t *log);
+
+int shell_log_write(shell_log_t *log, uint8_t source, const char *data, uint16_t length);
+
+int shell_log_print(shell_log_t *log, uint8_t source, const char *fmt, ...);
+
+uint16_t shell_log_peek(shell_log_t *log, const char **data);
+
+void shell_log_skip(shell_log_t *log);
+
+uint32_t shell_log_dropped(shell_log_t *log, uint8_t source);
+
+int shell_log_pending(shell_log_t *log);
+
+#endif /**< __SHELL_LOG_H__ */
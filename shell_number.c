@@ -0,0 +1,260 @@
+/**
+ * ********************************************************
+ * \file      shell_number.c
+ * \brief     shell numeric param parser realize
+ * \version   1.1
+ * \author    Awesome
+ * \copyright (c) 2026, Awesome
+ * ********************************************************
+ * \note      revision note
+ * |   Date    |  version  |  author   | Description
+ * |2026-10-18 |    1.0    |  Awesome  | init version
+ * |2026-10-18 |    1.1    |  Awesome  | real overflow reported, unsigned negate
+ * ********************************************************
+ */
+#include <math.h>
+#include <stdlib.h>
+#include "shell_number.h"
+
+/*-----------------------------------------------------------------------------*/
+/*! char to digit value + 1, 0 if not a digit */
+static const uint8_t shell_number_digit[256] = {
+    ['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5,
+    ['5'] = 6, ['6'] = 7, ['7'] = 8, ['8'] = 9, ['9'] = 10,
+    ['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16,
+    ['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16,
+};
+
+/*! exact powers of ten in double */
+static const double shell_number_pow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+/*! exact powers of ten in float */
+static const float shell_number_pow10f[] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f,
+};
+
+/*! table stores digit + 1 so that unlisted chars are 0 */
+#define SHELL_NUMBER_DIGIT(c)              ((uint8_t)(shell_number_digit[(uint8_t)(c)] - 1))
+
+/*! the value must not pass limit before taking the next digit */
+#define SHELL_NUMBER_FITS(v, d, limit, limit_digit) \
+        ((v) < (limit) || ((v) == (limit) && (d) <= (limit_digit)))
+
+/**
+ * -----------------------------------------------
+ * @brief      parse number
+ * @details    `0x` hex, `0b` binary, leading `0` octal,
+ *             decimal may have `.` and `e`
+ * -----------------------------------------------
+ * @param[in]  string : number string
+ * @param[out] number : parsed number
+ * @return     SHELL_NUMBER_OK or error
+ * -----------------------------------------------
+ */
+SHELL_NUMBER_ERROR_E shell_number_parse(const char *string, shell_number_t *number)
+{
+    const char *p = string;
+    const char *start;
+    uint8_t radix = 10;
+    uint8_t digit;
+    uint8_t inexact = 0;
+    uint64_t value = 0;
+    uint64_t limit = UINT64_MAX / 10;
+    uint8_t limit_digit = UINT64_MAX % 10;
+    int exponent = 0;
+    int scale = 0;
+    int exponent_sign = 1;
+    int count;
+
+    number->string = string;
+    number->exponent = 0;
+    number->is_negative = 0;
+    number->is_real = 0;
+
+    if(*p == '-' || *p == '+') {
+        number->is_negative = (*p == '-');
+        p++;
+    }
+    if(*p == '0' && (*(p + 1) == 'x' || *(p + 1) == 'X')) {
+        radix = 16;
+        limit = UINT64_MAX >> 4;
+        limit_digit = 0x0F;
+        p += 2;
+    } else if(*p == '0' && (*(p + 1) == 'b' || *(p + 1) == 'B')) {
+        radix = 2;
+        limit = UINT64_MAX >> 1;
+        limit_digit = 1;
+        p += 2;
+    }
+
+    /*! integer part, digits beyond 64 bits scale a real */
+    start = p;
+    while((digit = SHELL_NUMBER_DIGIT(*p)) < radix) {
+        if(SHELL_NUMBER_FITS(value, digit, limit, limit_digit)) {
+            value = value * radix + digit;
+        } else {
+            scale++;
+            inexact |= digit;
+        }
+        p++;
+    }
+    count = p - start;
+
+    if(radix == 10 && (*p == '.' || *p == 'e' || *p == 'E')) {
+        number->is_real = 1;
+        if(*p == '.') {
+            start = ++p;
+            while((digit = SHELL_NUMBER_DIGIT(*p)) < 10) {
+                if(SHELL_NUMBER_FITS(value, digit, limit, limit_digit)) {
+                    value = value * 10 + digit;
+                    scale--;
+                } else {
+                    inexact |= digit;
+                }
+                p++;
+            }
+            count += p - start;
+        }
+        if((*p == 'e' || *p == 'E') && count) {
+            p++;
+            if(*p == '-' || *p == '+') {
+                exponent_sign = (*p == '-') ? -1 : 1;
+                p++;
+            }
+            if(!*p) {
+                return SHELL_NUMBER_ERROR_DIGIT;
+            }
+            while((digit = SHELL_NUMBER_DIGIT(*p)) < 10) {
+                if(exponent < 10000) {
+                    exponent = exponent * 10 + digit;
+                }
+                p++;
+            }
+        }
+    }
+    number->mantissa = value;
+    number->is_inexact = (inexact != 0);
+    if(*p) {
+        return SHELL_NUMBER_ERROR_DIGIT;
+    }
+    if(count == 0) {
+        return SHELL_NUMBER_ERROR_EMPTY;
+    }
+    if(number->is_real) {
+        exponent = exponent_sign * exponent + scale;
+        number->exponent = (exponent > 9999) ? 9999 :
+                           (exponent < -9999) ? -9999 : exponent;
+        return SHELL_NUMBER_OK;
+    }
+    if(radix == 10 && *start == '0' && count > 1) {
+        /*! leading 0 integer is octal, scan again */
+        value = 0;
+        scale = 0;
+        for(p = start; *p; p++) {
+            digit = SHELL_NUMBER_DIGIT(*p);
+            if(digit >= 8) {
+                return SHELL_NUMBER_ERROR_DIGIT;
+            }
+            if(value > (UINT64_MAX >> 3)) {
+                scale = 1;
+            }
+            value = (value << 3) | digit;
+        }
+        number->mantissa = value;
+    }
+    /*! negative integer must fit int64 */
+    if(scale || (number->is_negative && number->mantissa > (1ULL << 63))) {
+        return SHELL_NUMBER_ERROR_OVERFLOW;
+    }
+    return SHELL_NUMBER_OK;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      get number as integer
+ * @details    real is truncated and saturated, positive magnitude
+ *             beyond int64 wraps, caller checks its own range
+ * -----------------------------------------------
+ */
+int64_t shell_number_int(const shell_number_t *number)
+{
+    double value;
+
+    if(number->is_real) {
+        shell_number_double(number, &value);
+        /*! cast of a real beyond int64 is undefined, saturate */
+        if(!(value < 9223372036854775808.0)) {
+            return (value != value) ? 0 : INT64_MAX;
+        }
+        if(value < -9223372036854775808.0) {
+            return INT64_MIN;
+        }
+        return (int64_t)value;
+    }
+    /*! negate in unsigned, -2^63 has no positive int64 */
+    return number->is_negative ? (int64_t)(0 - number->mantissa)
+                               : (int64_t)number->mantissa;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      get number as double
+ * @details    exact when mantissa and 10 ^ exponent are
+ *             both exact in double, otherwise strtod
+ * @param[out] result : value, inf when out of range
+ * @return     SHELL_NUMBER_ERROR_OVERFLOW if beyond double
+ * -----------------------------------------------
+ */
+SHELL_NUMBER_ERROR_E shell_number_double(const shell_number_t *number, double *result)
+{
+    double value;
+
+    if(!number->is_real) {
+        value = (double)number->mantissa;
+    } else if(!number->is_inexact && number->mantissa <= (1ULL << 53) &&
+              number->exponent >= -22 && number->exponent <= 22)
+    {
+        value = (double)number->mantissa;
+        value = (number->exponent < 0) ? value / shell_number_pow10[-number->exponent]
+                                       : value * shell_number_pow10[number->exponent];
+    } else {
+        /*! string keeps the sign, beyond range is inf */
+        *result = strtod(number->string, NULL);
+        return isinf(*result) ? SHELL_NUMBER_ERROR_OVERFLOW : SHELL_NUMBER_OK;
+    }
+    *result = number->is_negative ? -value : value;
+    return SHELL_NUMBER_OK;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      get number as float
+ * @details    exact when mantissa and 10 ^ exponent are
+ *             both exact in float, otherwise strtof
+ * @param[out] result : value, inf when out of range
+ * @return     SHELL_NUMBER_ERROR_OVERFLOW if beyond float
+ * -----------------------------------------------
+ */
+SHELL_NUMBER_ERROR_E shell_number_float(const shell_number_t *number, float *result)
+{
+    float value;
+
+    if(!number->is_real) {
+        value = (float)number->mantissa;
+    } else if(!number->is_inexact && number->mantissa <= (1UL << 24) &&
+              number->exponent >= -10 && number->exponent <= 10)
+    {
+        value = (float)number->mantissa;
+        value = (number->exponent < 0) ? value / shell_number_pow10f[-number->exponent]
+                                       : value * shell_number_pow10f[number->exponent];
+    } else {
+        /*! string keeps the sign, beyond range is inf */
+        *result = strtof(number->string, NULL);
+        return isinf(*result) ? SHELL_NUMBER_ERROR_OVERFLOW : SHELL_NUMBER_OK;
+    }
+    *result = number->is_negative ? -value : value;
+    return SHELL_NUMBER_OK;
+}
@@ -0,0 +1,49 @@
+/**
+ * ********************************************************
+ * \file      shell_number.h
+ * \brief     shell numeric param parser
+ * \version   1.0
+ * \author    Awesome
+ * \copyright (c) 2026, Awesome
+ * ********************************************************
+ * \note      revision note
+ * |   Date    |  version  |  author   | Description
+ * |2026-10-18 |    1.0    |  Awesome  | init version
+ * ********************************************************
+ */
+
+#ifndef __SHELL_NUMBER_H__
+#define __SHELL_NUMBER_H__
+
+#include <stdint.h>
+
+/*-----------------------------------------------------------------------------*/
+/*! number parse result */
+typedef enum shell_number_error_e {
+    SHELL_NUMBER_OK = 0,                   /**< parse success */
+    SHELL_NUMBER_ERROR_EMPTY,              /**< no digit */
+    SHELL_NUMBER_ERROR_DIGIT,              /**< invalid char for the radix */
+    SHELL_NUMBER_ERROR_OVERFLOW,           /**< integer exceeds 64 bits, or real its type */
+} SHELL_NUMBER_ERROR_E;
+
+/*-----------------------------------------------------------------------------*/
+/*! parsed number, real is mantissa * 10 ^ exponent */
+typedef struct {
+    const char *string;                    /**< source string, for slow path of real */
+    uint64_t mantissa;                     /**< integer magnitude, or mantissa of real */
+    int16_t exponent;                      /**< decimal exponent of real */
+    uint8_t is_negative;                   /**< leading '-' */
+    uint8_t is_real;                       /**< has '.' or exponent */
+    uint8_t is_inexact;                    /**< mantissa dropped digits */
+} shell_number_t;
+
+/*-----------------------------------------------------------------------------*/
+SHELL_NUMBER_ERROR_E shell_number_parse(const char *string, shell_number_t *number);
+
+int64_t shell_number_int(const shell_number_t *number);
+
+SHELL_NUMBER_ERROR_E shell_number_double(const shell_number_t *number, double *result);
+
+SHELL_NUMBER_ERROR_E shell_number_float(const shell_number_t *number, float *result);
+
+#endif /**< __SHELL_NUMBER_H__ */
@@ -11,6 +11,13 @@
  * |2025-10-28 |    1.1    |  awesome  | init version    |
  * |2025-11-03 |    5.1    |  awesome  | add weak attr   |
  * |2026-01-27 |    1.2    |  Awesome  | add process bar |
+ * |2026-10-18 |    1.3    |  Awesome  | add tx ring     |
+ * |2026-10-18 |    1.4    |  Awesome  | add rx ring     |
+ * |2026-10-18 |    1.5    |  Awesome  | add history log |
+ * |2026-10-18 |    1.6    |  Awesome  | add shell lock  |
+ * |2026-10-18 |    1.7    |  Awesome  | add log queue   |
+ * |2026-10-18 |    1.8    |  Awesome  | history arena   |
+ * |2026-10-18 |    1.9    |  Awesome  | spin shell lock |
  * ********************************************************
  */
 #include "shell_port.h"
@@ -19,6 +26,23 @@
 
 shell_t shell;
 uint8_t shell_buffer[512];
+shell_ring_t shell_tx_ring;
+static uint8_t shell_tx_buffer[SHELL_TX_BUFFER_SIZE];
+shell_ring_t shell_rx_ring;
+static uint8_t shell_rx_buffer[SHELL_RX_BUFFER_SIZE];
+#if SHELL_HISTORY_MAX_NUMBER > 0
+static char shell_history_buffer[SHELL_HISTORY_BUFFER];
+#endif
+#if SHELL_USING_LOG == 1
+shell_log_t shell_log;
+#endif
+#if SHELL_HISTORY_MAX_NUMBER > 0 && SHELL_HISTORY_PERSIST == 1
+/*! kept over reset, startup code must not clear this section,
+ *  gnu ld: `.noinit (NOLOAD) : { *(.noinit) } > RAM` after .bss,
+ *  armcc scatter: `RW_NOINIT +0 UNINIT { *(.noinit) }` */
+static char shell_history_log[SHELL_HISTORY_LOG_SIZE]
+    __attribute__((section(SHELL_HISTORY_LOG_SECTION)));
+#endif
 
 __attribute__((weak)) int uart_send_byte(uint8_t *data, uint32_t size)
 {
@@ -30,20 +54,194 @@ __attribute__((weak)) int uart_receive(uint8_t *data, uint32_t size)
     return 0;
 }
 
+/**
+ * @brief start draining tx ring, called after every write and
+ *        again while waiting for space with SHELL_RING_POLICY_BLOCK,
+ *        override to enable tx irq or start dma
+ */
+__attribute__((weak)) void shell_tx_kick(shell_ring_t *ring)
+{
+    uint8_t *data;
+    uint16_t length;
+
+    /*! no tx irq, drain in caller context */
+    while((length = shell_ring_peek(ring, &data)) > 0) {
+        uart_send_byte(data, length);
+        shell_ring_skip(ring, length);
+    }
+}
+
+/**
+ * @brief get next byte to send, for uart tx irq
+ * @return 1 byte got, 0 ring empty, disable tx irq
+ */
+int shell_tx_isr_byte(uint8_t *data)
+{
+    return shell_ring_read(&shell_tx_ring, data, 1);
+}
+
+/**
+ * @brief release sent block and get next block, for dma complete callback
+ * @param sent bytes of last block, 0 for first block
+ * @return next block length, 0 ring empty
+ */
+uint16_t shell_tx_dma_next(uint16_t sent, uint8_t **data)
+{
+    shell_ring_skip(&shell_tx_ring, sent);
+    return shell_ring_peek(&shell_tx_ring, data);
+}
+
 int shell_write(uint8_t *data, uint16_t size)
 {
-    return uart_send_byte(data, size);
+    return shell_ring_push(&shell_tx_ring, data, size,
+                           SHELL_TX_POLICY, shell_tx_kick);
+}
+
+/**
+ * @brief wait for rx data, called by shell task when rx ring is empty,
+ *        override to take a semaphore on rtos
+ */
+__attribute__((weak)) void shell_rx_wait(void)
+{
+}
+
+/**
+ * @brief notify rx data, called by uart rx irq after filling rx ring,
+ *        override to give the semaphore of shell_rx_wait from isr
+ */
+__attribute__((weak)) void shell_rx_notify(void)
+{
 }
 
+/**
+ * @brief put received byte into rx ring, for uart rx irq
+ * @return 1 byte stored, 0 ring full, byte dropped
+ */
+int shell_rx_isr_byte(uint8_t data)
+{
+    int ret = shell_ring_write(&shell_rx_ring, &data, 1);
+    if(!ret) {
+        shell_rx_ring.dropped++;
+    }
+    shell_rx_notify();
+    return ret;
+}
+
+#if SHELL_USING_LOCK == 1
+/*! spin lock owner task, 0 if free, and its recursion depth */
+static uintptr_t shell_lock_owner;
+static uint16_t shell_lock_depth;
+
+/**
+ * @brief lock shell, recursive spin lock owned by SHELL_PORT_TASK_ID(),
+ *        tasks only, never from irq, override to take a rtos mutex
+ */
+__attribute__((weak)) int shell_lock(shell_t *shell)
+{
+    uintptr_t self = SHELL_PORT_TASK_ID();
+    uintptr_t owner;
+
+    (void)shell;
+    if(__atomic_load_n(&shell_lock_owner, __ATOMIC_RELAXED) != self) {
+        owner = 0;
+        while(!__atomic_compare_exchange_n(&shell_lock_owner, &owner, self, 0,
+                                           __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            owner = 0;
+            SHELL_PORT_LOCK_YIELD();
+        }
+    }
+    shell_lock_depth++;
+    return 0;
+}
+
+/**
+ * @brief unlock shell, frees the spin lock at the outermost unlock
+ */
+__attribute__((weak)) int shell_unlock(shell_t *shell)
+{
+    (void)shell;
+    if(--shell_lock_depth == 0) {
+        __atomic_store_n(&shell_lock_owner, 0, __ATOMIC_RELEASE);
+    }
+    return 0;
+}
+#endif
+
 int shell_read(uint8_t *data, uint16_t size)
 {
+#if SHELL_RX_USING_IRQ == 1
+    /*! bytes typed while a command runs stay in rx ring,
+        a log record wakes the shell task with nothing read */
+    while(shell_ring_used(&shell_rx_ring) == 0
+#if SHELL_USING_LOG == 1
+          && !shell_log_pending(&shell_log)
+#endif
+          )
+    {
+        shell_rx_wait();
+    }
+    return shell_ring_read(&shell_rx_ring, data, size);
+#else
     return uart_receive(data, size);
+#endif
+}
+
+#if SHELL_HISTORY_MAX_NUMBER > 0 && SHELL_HISTORY_PERSIST == 1
+/**
+ * @brief read history log, retained ram by default,
+ *        override to keep the log in flash or eeprom
+ * @return bytes read, -1 out of log
+ */
+__attribute__((weak)) signed short shell_history_read(uint32_t offset, char *data,
+                                                      uint16_t size)
+{
+    if(offset + size > SHELL_HISTORY_LOG_SIZE) {
+        return -1;
+    }
+    memcpy(data, shell_history_log + offset, size);
+    return size;
+}
+
+/**
+ * @brief write history log, offset 0 starts the log over
+ * @return bytes written, -1 out of log
+ */
+__attribute__((weak)) signed short shell_history_write(uint32_t offset, const char *data,
+                                                       uint16_t size)
+{
+    if(offset + size > SHELL_HISTORY_LOG_SIZE) {
+        return -1;
+    }
+    memcpy(shell_history_log + offset, data, size);
+    return size;
 }
+#endif
 
 void init_shell(void)
 {
+    shell_ring_init(&shell_tx_ring, shell_tx_buffer, SHELL_TX_BUFFER_SIZE);
+    shell_ring_init(&shell_rx_ring, shell_rx_buffer, SHELL_RX_BUFFER_SIZE);
     shell.write = shell_write;
     shell.read = shell_read;
+#if SHELL_HISTORY_MAX_NUMBER > 0
+    /*! own history arena, the whole shell buffer is the line */
+    shell.history.buffer = shell_history_buffer;
+    shell.history.size = SHELL_HISTORY_BUFFER;
+#endif
+#if SHELL_USING_LOG == 1
+    shell_log_init(&shell_log);
+    shell_log.notify = shell_rx_notify;
+    shell.log = &shell_log;
+#endif
+#if SHELL_USING_LOCK == 1
+    shell.lock = shell_lock;
+    shell.unlock = shell_unlock;
+#endif
+#if SHELL_HISTORY_MAX_NUMBER > 0 && SHELL_HISTORY_PERSIST == 1
+    shell.history_read = shell_history_read;
+    shell.history_write = shell_history_write;
+#endif
     shell_init(&shell, shell_buffer, 512);
 }
 
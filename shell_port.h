@@ -16,8 +16,65 @@
 #define __SHELL_PORT_H__
 
 #include "shell.h"
+#include "shell_ring.h"
+
+#ifndef SHELL_TX_BUFFER_SIZE
+#define SHELL_TX_BUFFER_SIZE               1024        /**< tx ring size, power of 2 */
+#endif
+
+#ifndef SHELL_TX_POLICY
+#define SHELL_TX_POLICY                    SHELL_RING_POLICY_BLOCK  /**< tx policy when ring is full */
+#endif
+
+#ifndef SHELL_RX_BUFFER_SIZE
+#define SHELL_RX_BUFFER_SIZE               256         /**< rx ring size, power of 2 */
+#endif
+
+#ifndef SHELL_RX_USING_IRQ
+#define SHELL_RX_USING_IRQ                 0           /**< whether rx ring is filled by uart irq */
+#endif
+
+#ifndef SHELL_HISTORY_LOG_SECTION
+#define SHELL_HISTORY_LOG_SECTION          ".noinit"   /**< retained ram section of history log */
+#endif
+
+#ifndef SHELL_PORT_TASK_ID
+#define SHELL_PORT_TASK_ID()               ((uintptr_t)1) /**< current task as non 0, such as `(uintptr_t)xTaskGetCurrentTaskHandle()` */
+#endif
+
+#ifndef SHELL_PORT_LOCK_YIELD
+#define SHELL_PORT_LOCK_YIELD()                        /**< let the lock owner run while waiting, such as `taskYIELD()` */
+#endif
+
 extern shell_t shell;
+extern shell_ring_t shell_tx_ring;
+extern shell_ring_t shell_rx_ring;
+#if SHELL_USING_LOG == 1
+extern shell_log_t shell_log;
+#endif
 
 void init_shell(void);
 
+int shell_tx_isr_byte(uint8_t *data);
+
+uint16_t shell_tx_dma_next(uint16_t sent, uint8_t **data);
+
+int shell_rx_isr_byte(uint8_t data);
+
+void shell_rx_wait(void);
+
+void shell_rx_notify(void);
+
+#if SHELL_USING_LOCK == 1
+int shell_lock(shell_t *shell);
+
+int shell_unlock(shell_t *shell);
+#endif
+
+#if SHELL_HISTORY_MAX_NUMBER > 0 && SHELL_HISTORY_PERSIST == 1
+signed short shell_history_read(uint32_t offset, char *data, uint16_t size);
+
+signed short shell_history_write(uint32_t offset, const char *data, uint16_t size);
+#endif
+
 #endif /*< __SHELL_PORT_H__ */
@@ -0,0 +1,467 @@
+/**
+ * ********************************************************
+ * @file      shell_port_linux.c
+ * @brief     shell linux host port, tx ring drained and rx ring
+ *            filled by threads standing in for uart irq
+ * @version   1.6
+ * @author    awesome
+ * @copyright (c) 2026, AWESOME
+ * ********************************************************
+ * @note      revision note
+ * |   Date    |  version  |  author   | Description  |
+ * |2026-10-18 |    1.0    |  awesome  | init version |
+ * |2026-10-18 |    1.1    |  awesome  | add rx ring  |
+ * |2026-10-18 |    1.2    |  awesome  | add pty & socketpair, zshell build |
+ * |2026-10-18 |    1.3    |  awesome  | history log file |
+ * |2026-10-18 |    1.4    |  awesome  | pthread shell lock |
+ * |2026-10-18 |    1.5    |  awesome  | log queue |
+ * |2026-10-18 |    1.6    |  awesome  | rx thread waits for ring space |
+ * ********************************************************
+ */
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include "shell_port_linux.h"
+
+shell_t shell;
+char shell_buffer[512];
+shell_ring_t shell_tx_ring;
+static uint8_t shell_tx_buffer[SHELL_TX_BUFFER_SIZE];
+shell_ring_t shell_rx_ring;
+static uint8_t shell_rx_buffer[SHELL_RX_BUFFER_SIZE];
+#if !defined(SHELL_PORT_ZSHELL) && SHELL_HISTORY_MAX_NUMBER > 0
+#define SHELL_PORT_HISTORY_ARENA           1
+static char shell_history_buffer[SHELL_HISTORY_BUFFER];
+#endif
+
+#if !defined(SHELL_PORT_ZSHELL) && SHELL_USING_LOG == 1
+#define SHELL_PORT_LOG                     1
+shell_log_t shell_log;
+#endif
+
+static pthread_t shell_tx_thread;
+static pthread_mutex_t shell_tx_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t shell_tx_data = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t shell_tx_space = PTHREAD_COND_INITIALIZER;
+static int shell_tx_fd = STDOUT_FILENO;
+static volatile int shell_tx_running;
+
+static pthread_t shell_rx_thread;
+static pthread_mutex_t shell_rx_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t shell_rx_data = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t shell_rx_space = PTHREAD_COND_INITIALIZER;
+static int shell_rx_fd = STDIN_FILENO;
+static volatile int shell_rx_closed;
+
+#if !defined(SHELL_PORT_ZSHELL) && SHELL_HISTORY_MAX_NUMBER > 0 && SHELL_HISTORY_PERSIST == 1
+#define SHELL_PORT_HISTORY                 1
+static int shell_history_fd = -1;
+#endif
+
+#if !defined(SHELL_PORT_ZSHELL) && SHELL_USING_LOCK == 1
+#define SHELL_PORT_LOCK                    1
+/*! recursive, cmd run under the lock may print */
+static pthread_mutex_t shell_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+#endif
+
+static int shell_pty_slave = -1;
+static struct termios shell_tty_saved;
+static int shell_tty_raw;
+
+/**
+ * @brief tx drain thread, stands in for uart tx irq
+ */
+static void *shell_tx_task(void *param)
+{
+    shell_ring_t *ring = (shell_ring_t *)param;
+    uint8_t *data;
+    uint16_t length;
+    ssize_t sent;
+
+    while(1) {
+        pthread_mutex_lock(&shell_tx_mutex);
+        while(shell_tx_running && shell_ring_used(ring) == 0) {
+            pthread_cond_wait(&shell_tx_data, &shell_tx_mutex);
+        }
+        pthread_mutex_unlock(&shell_tx_mutex);
+        if((length = shell_ring_peek(ring, &data)) == 0) {
+            break;
+        }
+        sent = write(shell_tx_fd, data, length);
+        shell_ring_skip(ring, sent > 0 ? sent : length);
+
+        pthread_mutex_lock(&shell_tx_mutex);
+        pthread_cond_broadcast(&shell_tx_space);
+        pthread_mutex_unlock(&shell_tx_mutex);
+    }
+    return NULL;
+}
+
+/**
+ * @brief wake tx thread, wait for space if ring is full
+ */
+void shell_tx_kick(shell_ring_t *ring)
+{
+    pthread_mutex_lock(&shell_tx_mutex);
+    pthread_cond_signal(&shell_tx_data);
+    if(shell_ring_free(ring) == 0) {
+        pthread_cond_wait(&shell_tx_space, &shell_tx_mutex);
+    }
+    pthread_mutex_unlock(&shell_tx_mutex);
+}
+
+/**
+ * @brief get next byte to send, for uart tx irq
+ */
+int shell_tx_isr_byte(uint8_t *data)
+{
+    return shell_ring_read(&shell_tx_ring, data, 1);
+}
+
+/**
+ * @brief release sent block and get next block, for dma complete callback
+ */
+uint16_t shell_tx_dma_next(uint16_t sent, uint8_t **data)
+{
+    shell_ring_skip(&shell_tx_ring, sent);
+    return shell_ring_peek(&shell_tx_ring, data);
+}
+
+/**
+ * @brief wait until tx ring is drained
+ */
+void shell_port_tx_sync(void)
+{
+    pthread_mutex_lock(&shell_tx_mutex);
+    while(shell_ring_used(&shell_tx_ring) != 0) {
+        pthread_cond_signal(&shell_tx_data);
+        pthread_cond_wait(&shell_tx_space, &shell_tx_mutex);
+    }
+    pthread_mutex_unlock(&shell_tx_mutex);
+}
+
+/**
+ * @brief wait for rx data
+ */
+void shell_rx_wait(void)
+{
+    pthread_mutex_lock(&shell_rx_mutex);
+    while(shell_ring_used(&shell_rx_ring) == 0 && !shell_rx_closed
+#ifdef SHELL_PORT_LOG
+          && !shell_log_pending(&shell_log)
+#endif
+          )
+    {
+        pthread_cond_wait(&shell_rx_data, &shell_rx_mutex);
+    }
+    pthread_mutex_unlock(&shell_rx_mutex);
+}
+
+/**
+ * @brief notify rx data
+ */
+void shell_rx_notify(void)
+{
+    pthread_mutex_lock(&shell_rx_mutex);
+    pthread_cond_signal(&shell_rx_data);
+    pthread_mutex_unlock(&shell_rx_mutex);
+}
+
+/**
+ * @brief put received byte into rx ring, for uart rx irq
+ */
+int shell_rx_isr_byte(uint8_t data)
+{
+    int ret = shell_ring_write(&shell_rx_ring, &data, 1);
+    if(!ret) {
+        shell_rx_ring.dropped++;
+    }
+    shell_rx_notify();
+    return ret;
+}
+
+/**
+ * @brief rx thread, stands in for uart rx irq, unlike the irq
+ *        it waits for space, typed ahead bytes are never dropped
+ */
+static void *shell_rx_task(void *param)
+{
+    shell_ring_t *ring = (shell_ring_t *)param;
+    uint8_t data[64];
+    ssize_t length;
+    ssize_t count;
+
+    while((length = read(shell_rx_fd, data, sizeof(data))) > 0) {
+        count = shell_ring_write(ring, data, length);
+        shell_rx_notify();
+        while(count < length) {
+            pthread_mutex_lock(&shell_rx_mutex);
+            while(shell_ring_free(ring) == 0) {
+                pthread_cond_wait(&shell_rx_space, &shell_rx_mutex);
+            }
+            pthread_mutex_unlock(&shell_rx_mutex);
+            count += shell_ring_write(ring, data + count, length - count);
+            shell_rx_notify();
+        }
+    }
+    shell_rx_closed = 1;
+    shell_rx_notify();
+    return NULL;
+}
+
+/**
+ * @brief restore terminal mode
+ */
+static void shell_tty_restore(void)
+{
+    if(shell_tty_raw) {
+        tcsetattr(shell_rx_fd, TCSANOW, &shell_tty_saved);
+        shell_tty_raw = 0;
+    }
+}
+
+static void shell_tty_signal(int sig)
+{
+    shell_tty_restore();
+    _exit(128 + sig);
+}
+
+/**
+ * @brief set terminal raw, keys reach shell byte by byte,
+ *        ctrl-c still kills the process
+ */
+static void shell_tty_set_raw(int fd)
+{
+    struct termios tty;
+
+    if(tcgetattr(fd, &shell_tty_saved) != 0) {
+        return;
+    }
+    tty = shell_tty_saved;
+    cfmakeraw(&tty);
+    tty.c_lflag |= ISIG;
+    tty.c_oflag |= OPOST | ONLCR;
+    if(tcsetattr(fd, TCSANOW, &tty) == 0) {
+        shell_tty_raw = 1;
+        signal(SIGINT, shell_tty_signal);
+        signal(SIGTERM, shell_tty_signal);
+    }
+}
+
+signed short shell_write(char *data, uint16_t size)
+{
+    return shell_ring_push(&shell_tx_ring, (uint8_t *)data, size,
+                           SHELL_TX_POLICY, shell_tx_kick);
+}
+
+signed short shell_read(char *data, uint16_t size)
+{
+    /*! bytes typed while a command runs stay in rx ring */
+    shell_rx_wait();
+    if(shell_ring_used(&shell_rx_ring) == 0) {
+        /*! woken by log with nothing typed */
+        return shell_rx_closed ? -1 : 0;
+    }
+    size = shell_ring_read(&shell_rx_ring, (uint8_t *)data, size);
+    pthread_mutex_lock(&shell_rx_mutex);
+    pthread_cond_signal(&shell_rx_space);
+    pthread_mutex_unlock(&shell_rx_mutex);
+    return size;
+}
+
+#ifdef SHELL_PORT_LOCK
+int shell_lock(shell_t *shell)
+{
+    (void)shell;
+    return pthread_mutex_lock(&shell_mutex);
+}
+
+int shell_unlock(shell_t *shell)
+{
+    (void)shell;
+    return pthread_mutex_unlock(&shell_mutex);
+}
+#endif
+
+#ifdef SHELL_PORT_HISTORY
+/**
+ * @brief read history log file
+ * @return bytes read, -1 out of log
+ */
+signed short shell_history_read(uint32_t offset, char *data, uint16_t size)
+{
+    if(offset + size > SHELL_HISTORY_LOG_SIZE ||
+       pread(shell_history_fd, data, size, offset) != size)
+    {
+        return -1;
+    }
+    return size;
+}
+
+/**
+ * @brief write history log file, offset 0 truncates the file
+ * @return bytes written, -1 out of log
+ */
+signed short shell_history_write(uint32_t offset, const char *data, uint16_t size)
+{
+    if(offset + size > SHELL_HISTORY_LOG_SIZE ||
+       (offset == 0 && ftruncate(shell_history_fd, 0) != 0) ||
+       pwrite(shell_history_fd, data, size, offset) != size)
+    {
+        return -1;
+    }
+    return size;
+}
+#endif
+
+/**
+ * @brief set shell io fd, call before init_shell
+ */
+void shell_port_set_fd(int rx, int tx)
+{
+    shell_rx_fd = rx;
+    shell_tx_fd = tx;
+}
+
+/**
+ * @brief run shell on a socketpair, call before init_shell
+ * @return peer fd for driver, -1 if fail
+ */
+int shell_port_socketpair(void)
+{
+    int fd[2];
+
+    if(socketpair(AF_UNIX, SOCK_STREAM, 0, fd) != 0) {
+        return -1;
+    }
+    shell_port_set_fd(fd[0], fd[0]);
+    return fd[1];
+}
+
+/**
+ * @brief run shell on pty master, call before init_shell
+ * @param name : slave name output, such as /dev/pts/3
+ * @param size : name buffer size
+ * @return master fd, -1 if fail
+ */
+int shell_port_pty(char *name, uint16_t size)
+{
+    struct termios tty;
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if(master < 0) {
+        return -1;
+    }
+    if(grantpt(master) != 0 || unlockpt(master) != 0 ||
+       ptsname_r(master, name, size) != 0)
+    {
+        close(master);
+        return -1;
+    }
+    /*! hold slave open, master read fails with EIO while no slave */
+    shell_pty_slave = open(name, O_RDWR | O_NOCTTY);
+    if(shell_pty_slave >= 0 && tcgetattr(shell_pty_slave, &tty) == 0) {
+        cfmakeraw(&tty);
+        tcsetattr(shell_pty_slave, TCSANOW, &tty);
+    }
+    shell_port_set_fd(master, master);
+    return master;
+}
+
+void init_shell(void)
+{
+    if(isatty(shell_rx_fd) && shell_rx_fd == STDIN_FILENO) {
+        shell_tty_set_raw(shell_rx_fd);
+    }
+    shell_ring_init(&shell_tx_ring, shell_tx_buffer, SHELL_TX_BUFFER_SIZE);
+    shell_tx_running = 1;
+    pthread_create(&shell_tx_thread, NULL, shell_tx_task, &shell_tx_ring);
+    shell_ring_init(&shell_rx_ring, shell_rx_buffer, SHELL_RX_BUFFER_SIZE);
+    pthread_create(&shell_rx_thread, NULL, shell_rx_task, &shell_rx_ring);
+    shell.write = shell_write;
+    shell.read = shell_read;
+#ifdef SHELL_PORT_HISTORY_ARENA
+    /*! own history arena, the whole shell buffer is the line */
+    shell.history.buffer = shell_history_buffer;
+    shell.history.size = SHELL_HISTORY_BUFFER;
+#endif
+#ifdef SHELL_PORT_LOG
+    shell_log_init(&shell_log);
+    shell_log.notify = shell_rx_notify;
+    shell.log = &shell_log;
+#endif
+#ifdef SHELL_PORT_LOCK
+    shell.lock = shell_lock;
+    shell.unlock = shell_unlock;
+#endif
+#ifdef SHELL_PORT_HISTORY
+    shell_history_fd = open(SHELL_HISTORY_FILE, O_RDWR | O_CREAT, 0600);
+    if(shell_history_fd >= 0) {
+        shell.history_read = shell_history_read;
+        shell.history_write = shell_history_write;
+    }
+#endif
+    shell_init(&shell, shell_buffer, sizeof(shell_buffer));
+}
+
+void shell_port_deinit(void)
+{
+    shell_port_tx_sync();
+    pthread_mutex_lock(&shell_tx_mutex);
+    shell_tx_running = 0;
+    pthread_cond_signal(&shell_tx_data);
+    pthread_mutex_unlock(&shell_tx_mutex);
+    pthread_join(shell_tx_thread, NULL);
+    pthread_cancel(shell_rx_thread);
+    pthread_join(shell_rx_thread, NULL);
+    shell_tty_restore();
+    if(shell_pty_slave >= 0) {
+        close(shell_pty_slave);
+        shell_pty_slave = -1;
+    }
+#ifdef SHELL_PORT_HISTORY
+    if(shell_history_fd >= 0) {
+        close(shell_history_fd);
+        shell_history_fd = -1;
+    }
+#endif
+}
+
+#if SHELL_PORT_LINUX_MAIN == 1
+int main(int argc, char *argv[])
+{
+    char name[64];
+    char data[SHELL_RX_BUFFER_SIZE];
+    signed short length;
+
+    if(argc > 1 && strcmp(argv[1], "pty") == 0) {
+        if(shell_port_pty(name, sizeof(name)) < 0) {
+            perror("pty");
+            return 1;
+        }
+        fprintf(stderr, "shell on %s\n", name);
+    }
+    init_shell();
+    while((length = shell.read(data, sizeof(data))) >= 0) {
+#ifdef SHELL_PORT_ZSHELL
+        for(signed short i = 0; i < length; i++) {
+            shell_handler(&shell, data[i]);
+        }
+#else
+        shell_handler_block(&shell, data, length);
+#endif
+#ifdef SHELL_PORT_LOG
+        shell_write_log(&shell);
+#endif
+    }
+    shell_port_deinit();
+    return 0;
+}
+#endif
@@ -0,0 +1,53 @@
+/**
+ * ********************************************************
+ * \file      shell_port_linux.h
+ * \brief     shell linux host port
+ * \version   1.3
+ * \author    awesome
+ * \copyright (c) 2026, AWESOME
+ * ********************************************************
+ * \note      revision note
+ * |   Date    |  version  |  author   | Description
+ * |2026-10-18 |    1.0    |  awesome  | init version
+ * |2026-10-18 |    1.2    |  awesome  | add pty & socketpair, zshell build
+ * |2026-10-18 |    1.3    |  awesome  | history log file
+ * ********************************************************
+ * \note      host build, shell or zshell
+ *   gcc -std=gnu99 -DSHELL_PORT_LINUX_MAIN=1 shell.c shell_number.c
+ *       shell_ring.c shell_log.c shell_port_linux.c -lpthread -o shell
+ *   gcc -std=gnu99 -DSHELL_PORT_LINUX_MAIN=1 -DSHELL_PORT_ZSHELL zshell.c
+ *       shell_number.c shell_ring.c shell_port_linux.c -lpthread -o zshell
+ *   ./shell            : run on current terminal
+ *   ./shell pty        : run on a new pty, attach to printed slave
+ *   history is kept in SHELL_HISTORY_FILE of working directory
+ * ********************************************************
+ */
+
+#ifndef __SHELL_PORT_LINUX_H__
+#define __SHELL_PORT_LINUX_H__
+
+#ifdef SHELL_PORT_ZSHELL
+#include "zshell_port.h"
+#else
+#include "shell_port.h"
+#endif
+
+#ifndef SHELL_PORT_LINUX_MAIN
+#define SHELL_PORT_LINUX_MAIN              0           /**< whether to build host main */
+#endif
+
+#ifndef SHELL_HISTORY_FILE
+#define SHELL_HISTORY_FILE                 ".shell_history"  /**< history log file */
+#endif
+
+void shell_port_set_fd(int rx, int tx);
+
+int shell_port_socketpair(void);
+
+int shell_port_pty(char *name, uint16_t size);
+
+void shell_port_tx_sync(void);
+
+void shell_port_deinit(void);
+
+#endif /*< __SHELL_PORT_LINUX_H__ */
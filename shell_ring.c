@@ -0,0 +1,193 @@
+/**
+ * ********************************************************
+ * \file      shell_ring.c
+ * \brief     shell port byte ring buffer realize
+ * \version   1.0
+ * \author    Awesome
+ * \copyright (c) 2026, Awesome
+ * ********************************************************
+ * \note      revision note
+ * |   Date    |  version  |  author   | Description
+ * |2026-10-18 |    1.0    |  Awesome  | init version
+ * ********************************************************
+ */
+#include <string.h>
+#include "shell_ring.h"
+
+/**
+ * -----------------------------------------------
+ * @brief      init ring
+ * -----------------------------------------------
+ * @param[in]  ring  : ring obj
+ * @param[in]  buffer: ring buffer
+ * @param[in]  size  : ring buffer size, must be power of 2
+ * -----------------------------------------------
+ */
+void shell_ring_init(shell_ring_t *ring, uint8_t *buffer, uint16_t size)
+{
+    ring->buffer = buffer;
+    ring->size = size;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->dropped = 0;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      get ring used length
+ * -----------------------------------------------
+ * @param[in]  ring : ring obj
+ * @return     bytes can be read
+ * -----------------------------------------------
+ */
+uint16_t shell_ring_used(shell_ring_t *ring)
+{
+    return (uint16_t)(SHELL_RING_LOAD(ring->head) - SHELL_RING_LOAD(ring->tail));
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      get ring free length
+ * -----------------------------------------------
+ * @param[in]  ring : ring obj
+ * @return     bytes can be written
+ * -----------------------------------------------
+ */
+uint16_t shell_ring_free(shell_ring_t *ring)
+{
+    return ring->size - shell_ring_used(ring);
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      write ring, producer side
+ * -----------------------------------------------
+ * @param[in]  ring  : ring obj
+ * @param[in]  data  : data to write
+ * @param[in]  length: data length
+ * @return     bytes written, may be less than length
+ * -----------------------------------------------
+ */
+uint16_t shell_ring_write(shell_ring_t *ring, const uint8_t *data, uint16_t length)
+{
+    uint16_t head = ring->head;
+    uint16_t space = ring->size - (uint16_t)(head - SHELL_RING_LOAD(ring->tail));
+    uint16_t offset = head & (ring->size - 1);
+    uint16_t first;
+
+    if(length > space) {
+        length = space;
+    }
+    first = ring->size - offset;
+    if(first > length) {
+        first = length;
+    }
+    memcpy(ring->buffer + offset, data, first);
+    memcpy(ring->buffer, data + first, length - first);
+    SHELL_RING_STORE(ring->head, (uint16_t)(head + length));
+    return length;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      read ring, consumer side
+ * -----------------------------------------------
+ * @param[in]  ring  : ring obj
+ * @param[out] data  : read buffer
+ * @param[in]  length: read buffer size
+ * @return     bytes read
+ * -----------------------------------------------
+ */
+uint16_t shell_ring_read(shell_ring_t *ring, uint8_t *data, uint16_t length)
+{
+    uint16_t tail = ring->tail;
+    uint16_t used = (uint16_t)(SHELL_RING_LOAD(ring->head) - tail);
+    uint16_t offset = tail & (ring->size - 1);
+    uint16_t first;
+
+    if(length > used) {
+        length = used;
+    }
+    first = ring->size - offset;
+    if(first > length) {
+        first = length;
+    }
+    memcpy(data, ring->buffer + offset, first);
+    memcpy(data + first, ring->buffer, length - first);
+    SHELL_RING_STORE(ring->tail, (uint16_t)(tail + length));
+    return length;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      peek ring, consumer side
+ * @details    get the contiguous readable block without
+ *             consuming it, such as the source of a dma
+ * -----------------------------------------------
+ * @param[in]  ring : ring obj
+ * @param[out] data : block start
+ * @return     block length
+ * -----------------------------------------------
+ */
+uint16_t shell_ring_peek(shell_ring_t *ring, uint8_t **data)
+{
+    uint16_t tail = ring->tail;
+    uint16_t used = (uint16_t)(SHELL_RING_LOAD(ring->head) - tail);
+    uint16_t offset = tail & (ring->size - 1);
+
+    *data = ring->buffer + offset;
+    return (used > ring->size - offset) ? (ring->size - offset) : used;
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      skip ring, consumer side
+ * @details    consume bytes returned by shell_ring_peek
+ * -----------------------------------------------
+ * @param[in]  ring  : ring obj
+ * @param[in]  length: bytes to consume
+ * -----------------------------------------------
+ */
+void shell_ring_skip(shell_ring_t *ring, uint16_t length)
+{
+    SHELL_RING_STORE(ring->tail, (uint16_t)(ring->tail + length));
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      push ring with policy, producer side
+ * -----------------------------------------------
+ * @param[in]  ring  : ring obj
+ * @param[in]  data  : data to write
+ * @param[in]  length: data length
+ * @param[in]  policy: policy when ring is full
+ * @param[in]  kick  : start consumer, may wait for space when
+ *                     ring is full, can be NULL
+ * @return     bytes written
+ * -----------------------------------------------
+ */
+uint16_t shell_ring_push(shell_ring_t *ring, const uint8_t *data, uint16_t length,
+                         SHELL_RING_POLICY_E policy, void (*kick)(shell_ring_t *))
+{
+    uint16_t count = 0;
+
+    if(policy == SHELL_RING_POLICY_DROP && length > shell_ring_free(ring)) {
+        ring->dropped += length;
+        return 0;
+    }
+    count = shell_ring_write(ring, data, length);
+    if(kick) {
+        kick(ring);
+    }
+    if(policy == SHELL_RING_POLICY_BLOCK) {
+        while(count < length) {
+            count += shell_ring_write(ring, data + count, length - count);
+            if(kick) {
+                kick(ring);
+            }
+        }
+    } else {
+        ring->dropped += length - count;
+    }
+    return count;
+}
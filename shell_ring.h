@@ -0,0 +1,61 @@
+/**
+ * ********************************************************
+ * \file      shell_ring.h
+ * \brief     shell port byte ring buffer
+ * \version   1.0
+ * \author    Awesome
+ * \copyright (c) 2026, Awesome
+ * ********************************************************
+ * \note      revision note
+ * |   Date    |  version  |  author   | Description
+ * |2026-10-18 |    1.0    |  Awesome  | init version
+ * ********************************************************
+ */
+
+#ifndef __SHELL_RING_H__
+#define __SHELL_RING_H__
+
+#include <stdint.h>
+
+/*-----------------------------------------------------------------------------*/
+/*! ring write policy when ring has not enough space */
+typedef enum shell_ring_policy_e {
+    SHELL_RING_POLICY_BLOCK = 0,          /**< wait until all data written */
+    SHELL_RING_POLICY_DROP,               /**< drop the whole write */
+    SHELL_RING_POLICY_TRUNCATE,           /**< write what fits, drop the rest */
+} SHELL_RING_POLICY_E;
+
+/*-----------------------------------------------------------------------------*/
+/*! single producer & single consumer index access */
+#define SHELL_RING_LOAD(x)                 __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define SHELL_RING_STORE(x, v)             __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+
+/*-----------------------------------------------------------------------------*/
+/*! shell ring struct */
+typedef struct {
+    uint8_t *buffer;                       /**< ring buffer */
+    uint16_t size;                         /**< ring size, power of 2 */
+    uint16_t head;                         /**< write index, owned by producer */
+    uint16_t tail;                         /**< read index, owned by consumer */
+    uint32_t dropped;                      /**< dropped bytes */
+} shell_ring_t;
+
+/*-----------------------------------------------------------------------------*/
+void shell_ring_init(shell_ring_t *ring, uint8_t *buffer, uint16_t size);
+
+uint16_t shell_ring_used(shell_ring_t *ring);
+
+uint16_t shell_ring_free(shell_ring_t *ring);
+
+uint16_t shell_ring_write(shell_ring_t *ring, const uint8_t *data, uint16_t length);
+
+uint16_t shell_ring_read(shell_ring_t *ring, uint8_t *data, uint16_t length);
+
+uint16_t shell_ring_peek(shell_ring_t *ring, uint8_t **data);
+
+void shell_ring_skip(shell_ring_t *ring, uint16_t length);
+
+uint16_t shell_ring_push(shell_ring_t *ring, const uint8_t *data, uint16_t length,
+                         SHELL_RING_POLICY_E policy, void (*kick)(shell_ring_t *));
+
+#endif /**< __SHELL_RING_H__ */
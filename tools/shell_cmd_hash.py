@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+"""
+********************************************************
+\\file      shell_cmd_hash.py
+\\brief     shell cmd perfect hash generator
+\\version   1.0
+\\author    Awesome
+\\copyright (c) 2026, Awesome
+********************************************************
+\\note      revision note
+|   Date    |  version  |  author   | Description
+|2026-10-18 |    1.0    |  Awesome  | init version
+********************************************************
+\\note      reads preprocessed sources, collects cmd/var/user
+           records of shell_sec, and writes a minimal perfect
+           hash of their names (hash and displace) as const c,
+           so shell_seek_cmd costs one hash and one compare
+  gcc -E -I. shell.c app.c | python3 tools/shell_cmd_hash.py -o shell_cmd_hash.c
+  gcc ... shell.c app.c shell_cmd_hash.c
+           sources must be preprocessed with the flags of the
+           build, records under #if are then seen as built
+********************************************************
+"""
+import argparse
+import re
+import sys
+
+MASK = 0xFFFFFFFF
+DISP_MAX = 0x10000
+SEED_MAX = 64
+
+ATTR = r'__attribute__\s*\(\((?:[^()]|\([^()]*\))*\)\)'
+STRING_RE = re.compile(r'\bconst\s+char\s+(\w+)\s*\[\s*\]\s*(?:' + ATTR + r'\s*)*=\s*'
+                       r'((?:"(?:[^"\\]|\\.)*"\s*)+);')
+RECORD_RE = re.compile(r'\bconst\s+shell_cmd_t\s+(\w+)\s*((?:' + ATTR + r'\s*)*)=\s*\{')
+NAME_RE = re.compile(r'\.data\.(?:cmd|var|user)\.name\s*=\s*(\w+)')
+LITERAL_RE = re.compile(r'"((?:[^"\\]|\\.)*)"')
+
+
+def c_string(literal):
+    """value of adjacent c string literals"""
+    data = b''
+    for part in LITERAL_RE.findall(literal):
+        data += part.encode('latin-1').decode('unicode_escape').encode('latin-1')
+    return data
+
+
+def record_body(text, start):
+    """text of record initializer from its opening brace"""
+    depth = 0
+    for i in range(start, len(text)):
+        if text[i] == '{':
+            depth += 1
+        elif text[i] == '}':
+            depth -= 1
+            if depth == 0:
+                return text[start:i]
+    return text[start:]
+
+
+def collect(text, section):
+    """(name, symbol) of every extern record placed in section"""
+    text = re.sub(r'^\s*#.*$', '', text, flags=re.M)
+    strings = {m.group(1): c_string(m.group(2)) for m in STRING_RE.finditer(text)}
+    records = {}
+    for m in RECORD_RE.finditer(text):
+        if not re.search(r'section\s*\(\s*"' + re.escape(section) + r'"', m.group(2)):
+            continue
+        head = text[max(text.rfind(';', 0, m.start()), text.rfind('}', 0, m.start())) + 1:m.start()]
+        if re.search(r'\bstatic\b', head):
+            continue
+        name = NAME_RE.search(record_body(text, m.end() - 1))
+        if not name or name.group(1) not in strings:
+            sys.exit('shell_cmd_hash: no name of %s' % m.group(1))
+        records[m.group(1)] = strings[name.group(1)]
+    names = {}
+    for symbol, name in records.items():
+        if name in names:
+            sys.exit('shell_cmd_hash: %s and %s share name "%s"'
+                     % (names[name], symbol, name.decode('latin-1')))
+        names[name] = symbol
+    return sorted(names.items())
+
+
+def name_hash(name, seed):
+    """fnv-1a, same as shell_cmd_hash_slot"""
+    h = 2166136261 ^ seed
+    for c in name:
+        h = ((h ^ c) * 16777619) & MASK
+    return h
+
+
+def slot_of(h, disp, count):
+    h ^= (disp * 0x9E3779B9) & MASK
+    h ^= h >> 16
+    h = (h * 0x85EBCA6B) & MASK
+    h ^= h >> 13
+    return h % count
+
+
+def build(names, seed):
+    """displacement of each bucket and slot of each name, None if no fit"""
+    count = len(names)
+    bucket_count = count // 3 + 1
+    hashes = [name_hash(name, seed) for name, _ in names]
+    buckets = [[] for _ in range(bucket_count)]
+    for i, h in enumerate(hashes):
+        buckets[h % bucket_count].append(i)
+    disp = [0] * bucket_count
+    slot = [None] * count
+    for b in sorted(range(bucket_count), key=lambda b: -len(buckets[b])):
+        if not buckets[b]:
+            break
+        for d in range(DISP_MAX):
+            taken = [slot_of(hashes[i], d, count) for i in buckets[b]]
+            if len(set(taken)) == len(taken) and all(slot[t] is None for t in taken):
+                break
+        else:
+            return None
+        disp[b] = d
+        for i, t in zip(buckets[b], taken):
+            slot[t] = i
+    return disp, slot
+
+
+def write(out, names, seed, disp, slot):
+    count = len(names)
+    out.write('/**\n'
+              ' * ********************************************************\n'
+              ' * \\file      shell_cmd_hash.c\n'
+              ' * \\brief     shell cmd perfect hash, %d cmd/var/user\n'
+              ' * ********************************************************\n'
+              ' * \\note      generated by tools/shell_cmd_hash.py, do not edit\n'
+              ' * ********************************************************\n'
+              ' */\n'
+              '#include "shell.h"\n\n'
+              '#if SHELL_USING_CMD_INDEX == 1 && SHELL_CMD_INDEX_MAX < %d\n'
+              '#error "SHELL_CMD_INDEX_MAX below the %d cmd/var/user of the table"\n'
+              '#endif\n\n'
+              '#if SHELL_USING_CMD_HASH == 1\n' % (count, count, count))
+    for _, symbol in names:
+        out.write('extern const shell_cmd_t %s;\n' % symbol)
+    out.write('\nstatic const uint16_t shell_cmd_hash_disp[%d] = {' % len(disp))
+    for i, d in enumerate(disp):
+        out.write('%s%u,' % ('\n    ' if i % 12 == 0 else ' ', d))
+    out.write('\n};\n\nstatic const shell_cmd_t *const shell_cmd_hash_slot[%d] = {\n' % count)
+    for i in slot:
+        out.write('    &%s,\n' % names[i][1])
+    out.write('};\n\n'
+              'const shell_cmd_hash_t shell_cmd_hash = {\n'
+              '    .seed = 0x%08XUL,\n'
+              '    .count = %d,\n'
+              '    .bucket_count = %d,\n'
+              '    .disp = shell_cmd_hash_disp,\n'
+              '    .slot = shell_cmd_hash_slot,\n'
+              '};\n'
+              '#endif /** SHELL_USING_CMD_HASH == 1 */\n' % (seed, count, len(disp)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='shell cmd perfect hash generator')
+    parser.add_argument('source', nargs='*', help='preprocessed sources, stdin if none')
+    parser.add_argument('-o', '--output', help='output c file, stdout if none')
+    parser.add_argument('--section', default='shell_sec', help='cmd section name')
+    args = parser.parse_args()
+
+    text = ''
+    for path in args.source or ['-']:
+        with (sys.stdin if path == '-' else open(path, encoding='latin-1')) as f:
+            text += f.read() + '\n'
+    names = collect(text, args.section)
+    if not names:
+        sys.exit('shell_cmd_hash: no record in section %s' % args.section)
+    if len(names) > 0xFFFF:
+        sys.exit('shell_cmd_hash: too many records')
+    for seed in range(SEED_MAX):
+        table = build(names, seed)
+        if table:
+            break
+    else:
+        sys.exit('shell_cmd_hash: no perfect hash found')
+    out = open(args.output, 'w') if args.output else sys.stdout
+    write(out, names, seed, *table)
+    if out is not sys.stdout:
+        out.close()
+
+
+if __name__ == '__main__':
+    main()
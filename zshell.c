@@ -13,6 +13,8 @@
  * |2025-10-31 |    1.1    |  Awesome  | modify to c style
  * |2025-11-03 |    1.2    |  Awesome  | merge ext.c to shell.c
  * |2026-01-27 |    1.2    |  Awesome  | modify section setting
+ * |2026-10-18 |    1.2    |  Awesome  | add gnu ld section bounds
+ * |2026-10-18 |    1.2    |  Awesome  | use shell_number param parser
  * ********************************************************
  */
 #include <string.h>
@@ -20,20 +22,27 @@
 #include <stdarg.h>
 #include "zshell.h"
 #include "zshell_cfg.h"
+#include "shell_number.h"
 
  /*-----------------------------------------------------------------------------*/
- /*! shell command section address */
-#if 0 
+ /*! shell command section address, see SHELL_SECTION_BOUNDS */
+#if SHELL_SECTION_BOUNDS == 2
 extern const unsigned int _shell_command_start;
 extern const unsigned int _shell_command_end;
-const uint32_t shell_sec_start = (uint32_t)&_shell_command_start;
-const uint32_t shell_sec_end = (uint32_t)&_shell_command_end;
+const size_t shell_sec_start = (size_t)&_shell_command_start;
+const size_t shell_sec_end = (size_t)&_shell_command_end;
+#elif SHELL_SECTION_BOUNDS == 1
+/*! gnu ld provides bounds of sections named as c identifier */
+extern const shell_cmd_t __start_shell_sec[];
+extern const shell_cmd_t __stop_shell_sec[];
+const size_t shell_sec_start = (size_t)__start_shell_sec;
+const size_t shell_sec_end = (size_t)__stop_shell_sec;
 #else
 extern const uint32_t shell_sec$$Base;
 extern const uint32_t shell_sec$$Limit;
-const uint32_t shell_sec_start = &shell_sec$$Base;
-const uint32_t shell_sec_end = &shell_sec$$Limit;
-#endif /**< __GNUC__ */
+const size_t shell_sec_start = (size_t)&shell_sec$$Base;
+const size_t shell_sec_end = (size_t)&shell_sec$$Limit;
+#endif /**< SHELL_SECTION_BOUNDS */
 /*-----------------------------------------------------------------------------*/
 
 /**
@@ -123,6 +132,48 @@ static void shell_write_cmd_help(shell_t* shell, char* cmd);
 /*-----------------------------------------------------------------------------*/
 /*-----------------------------------------------------------------------------*/
 
+/**
+ * -----------------------------------------------
+ * @brief      flush staged output to shell
+ * -----------------------------------------------
+ * @param[in]  shell: shell obj
+ * -----------------------------------------------
+ */
+void shell_write_flush(shell_t* shell)
+{
+    if (shell->output.length) {
+        shell->write(shell->output.buffer, shell->output.length);
+        shell->output.length = 0;
+    }
+}
+
+/**
+ * -----------------------------------------------
+ * @brief      write data to shell
+ * @details    data is staged while the shell is handling
+ *             input or running command, and written through
+ *             in any other context
+ * -----------------------------------------------
+ * @param[in]  shell : shell obj
+ * @param[in]  data  : data to write
+ * @param[in]  length: data length
+ * @return     num of bytes written
+ * -----------------------------------------------
+ */
+static uint16_t shell_write_data(shell_t* shell, const char* data, uint16_t length)
+{
+    if (!shell->output.hold || length >= shell->output.size) {
+        shell_write_flush(shell);
+        return shell->write((char*)data, length);
+    }
+    if (length > shell->output.size - shell->output.length) {
+        shell_write_flush(shell);
+    }
+    memcpy(shell->output.buffer + shell->output.length, data, length);
+    shell->output.length += length;
+    return length;
+}
+
 /**
  * -----------------------------------------------
  * @brief      write byte to shell
@@ -133,7 +184,7 @@ static void shell_write_cmd_help(shell_t* shell, char* cmd);
  */
 static void shell_write_byte(shell_t* shell, char data)
 {
-    shell->write(&data, 1);
+    shell_write_data(shell, &data, 1);
 }
 /**
  * -----------------------------------------------
@@ -154,7 +205,7 @@ uint16_t shell_write_string(shell_t* shell, const char* string)
     while (*p++) {
         count++;
     }
-    return shell->write((char*)string, count);
+    return shell_write_data(shell, string, count);
 }
 
 /**
@@ -179,11 +230,11 @@ static uint16_t shell_write_cmd_desc(shell_t* shell, const char* string)
     }
 
     if (count > 36) {
-        shell->write((char*)string, 36);
-        shell->write("...", 3);
+        shell_write_data(shell, string, 36);
+        shell_write_data(shell, "...", 3);
     }
     else {
-        shell->write((char*)string, count);
+        shell_write_data(shell, string, count);
     }
     return count > 36 ? 36 : 39;
 }
@@ -209,6 +260,7 @@ static void shell_write_prompt(shell_t* shell, uint8_t newline)
     shell_write_string(shell, ":");
     shell_write_string(shell, "~");
     shell_write_string(shell, "$ ");
+    shell_write_flush(shell);
 }
 
 
@@ -334,6 +386,17 @@ void shell_init(shell_t* shell, char* buffer, uint16_t size)
     shell->parser.buffer = buffer;
     shell->parser.buffer_size = size / (SHELL_HISTORY_MAX_NUMBER + 1);
 
+    /*! shell output init */
+#if SHELL_OUTPUT_BUFFER > 0
+    shell->output.buffer = shell->output.data;
+    shell->output.size = SHELL_OUTPUT_BUFFER;
+#else
+    shell->output.buffer = NULL;
+    shell->output.size = 0;
+#endif
+    shell->output.length = 0;
+    shell->output.hold = 0;
+
     /*! shell history init */
     shell->history.offset = 0;
     shell->history.number = 0;
@@ -693,6 +756,8 @@ shell_cmd_t* shell_seek_cmd(shell_t* shell,
 unsigned int shell_run_command(shell_t* shell, shell_cmd_t* command)
 {
     int return_value = 0;
+    /*! command may write to the port directly */
+    shell_write_flush(shell);
     if (command->attr.para.type == SHELL_TYPE_CMD_FUNC)
     {
         return_value = shell_register_run(shell,
@@ -704,6 +769,7 @@ unsigned int shell_run_command(shell_t* shell, shell_cmd_t* command)
             shell_write_return_value(shell, return_value);
         }
     }
+    shell_write_flush(shell);
 
     return return_value;
 }
@@ -1112,7 +1178,7 @@ CMD_REGISTER(SHELL_CMD_DISABLE_RETURN, help, shell_help, show command info);
 void shell_handler(shell_t* shell, char data)
 {
     SHELL_ASSERT(data);
-
+    shell->output.hold++;
 
     char keyByteOffset = 24;
     int keyFilter = 0x00000000;
@@ -1158,7 +1224,8 @@ void shell_handler(shell_t* shell, char data)
         shell->parser.key_value = 0x00000000;
         shell_normal_input(shell, data);
     }
-
+    shell->output.hold--;
+    shell_write_flush(shell);
 }
 /**
  * -----------------------------------------------
@@ -1233,7 +1300,10 @@ int shell_run(shell_t* shell, const char* cmd)
     }
     else {
         shell->parser.length = shell_string_copy(shell->parser.buffer, (char*)cmd);
+        shell->output.hold++;
         shell_exec(shell);
+        shell->output.hold--;
+        shell_write_flush(shell);
         return 0;
     }
 }
@@ -1244,75 +1314,6 @@ int shell_run(shell_t* shell, const char* cmd)
 /*---------------------------  shell register  --------------------------------*/
 /*-----------------------------------------------------------------------------*/
 /*-----------------------------------------------------------------------------*/
-/**
- * -----------------------------------------------
- * @brief      shell parse number type
- * @details    parse number type from string
- * -----------------------------------------------
- * @param[in]  string number string
- * @param[out] type number type
- * @return     SHELL_NUM_TYPE_E number type
- * -----------------------------------------------
- */
-static SHELL_NUM_TYPE_E shell_register_num_type(char* string)
-{
-    char* p = string;
-    SHELL_NUM_TYPE_E type = NUM_TYPE_DEC;
-
-    if ((*p == '0') && ((*(p + 1) == 'x') || (*(p + 1) == 'X')))
-    {
-        type = NUM_TYPE_HEX;
-    }
-    else if ((*p == '0') && ((*(p + 1) == 'b') || (*(p + 1) == 'B')))
-    {
-        type = NUM_TYPE_BIN;
-    }
-    else if (*p == '0')
-    {
-        type = NUM_TYPE_OCT;
-    }
-
-    while (*p++)
-    {
-        if (*p == '.' && *(p + 1) != 0)
-        {
-            type = NUM_TYPE_FLOAT;
-            break;
-        }
-    }
-
-    return type;
-}
-
-/**
- * -----------------------------------------------
- * @brief      shell char to number
- * @details    convert char to number
- * -----------------------------------------------
- * @param[in]  code char to convert
- * @return     char number
- * -----------------------------------------------
- */
-static char shell_register_char_to_num(char code)
-{
-    if ((code >= '0') && (code <= '9'))
-    {
-        return code - '0';
-    }
-    else if ((code >= 'a') && (code <= 'f'))
-    {
-        return code - 'a' + 10;
-    }
-    else if ((code >= 'A') && (code <= 'F'))
-    {
-        return code - 'A' + 10;
-    }
-    else
-    {
-        return 0;
-    }
-}
-
 /**
  * -----------------------------------------------
  * @brief      shell parse char
@@ -1402,74 +1403,44 @@ static char* shell_register_parse_string(char* string)
 /**
  * -----------------------------------------------
  * @brief      shell parse number
- * @details    parse number from string
+ * @details    parse number from string, real is passed
+ *             as float bits
  * -----------------------------------------------
  * @param[in]  string number string
- * @return     size_t number value
+ * @param[out] result number value
+ * @return     int 0 parse success -1 parse fail or out of range
  * -----------------------------------------------
  */
-static size_t shell_register_parse_number(char* string)
+static int shell_register_parse_number(char* string, size_t* result)
 {
-    SHELL_NUM_TYPE_E type = NUM_TYPE_DEC;
-    char radix = 10;
-    char* p = string;
-    char offset = 0;
-    signed char sign = 1;
-    size_t value_int = 0;
-    float value_float = 0.0;
-    size_t devide = 0;
+    shell_number_t number;
+    int64_t value;
+    float value_float;
 
-    if (*string == '-')
+    if (shell_number_parse(string, &number) != SHELL_NUMBER_OK)
     {
-        sign = -1;
-    }
-
-    type = shell_register_num_type(string + ((sign == -1) ? 1 : 0));
-
-    switch ((char)type)
-    {
-    case NUM_TYPE_HEX:
-        radix = 16;
-        offset = 2;
-        break;
-
-    case NUM_TYPE_OCT:
-        radix = 8;
-        offset = 1;
-        break;
-
-    case NUM_TYPE_BIN:
-        radix = 2;
-        offset = 2;
-        break;
-
-    default:
-        break;
+        return -1;
     }
-
-    p = string + offset + ((sign == -1) ? 1 : 0);
-
-    while (*p)
+    if (number.is_real)
     {
-        if (*p == '.')
+        if (shell_number_float(&number, &value_float) != SHELL_NUMBER_OK)
         {
-            devide = 1;
-            p++;
-            continue;
+            return -1;
         }
-        value_int = value_int * radix + shell_register_char_to_num(*p);
-        devide *= 10;
-        p++;
-    }
-    if (type == NUM_TYPE_FLOAT && devide != 0)
-    {
-        value_float = (float)value_int / devide * sign;
-        return *(size_t*)(&value_float);
+        *result = 0;
+        memcpy(result, &value_float, sizeof(value_float));
+        return 0;
     }
-    else
+    value = shell_number_int(&number);
+    /*! accept both signed and unsigned range of size_t */
+    if (sizeof(size_t) < sizeof(value) &&
+        (value < -(1LL << (sizeof(size_t) * 8 - 1)) ||
+         (!number.is_negative && (number.mantissa >> (sizeof(size_t) * 8)))))
     {
-        return value_int * sign;
+        return -1;
     }
+    *result = (size_t)value;
+    return 0;
 }
 
 
@@ -1496,8 +1467,7 @@ static int shell_register_parse_para(shell_t* shell, char* string, char* type, s
         }
         else if (*string == '-' || (*string >= '0' && *string <= '9'))
         {
-            *result = shell_register_parse_number(string);
-            return 0;
+            return shell_register_parse_number(string, result);
         }
         else if (*string == '$' && *(string + 1))
         {
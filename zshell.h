@@ -143,6 +143,17 @@ typedef struct {
         uint16_t count;                           /**< cmd num */
     } command_list;
     
+    /*! shell output staging */
+    struct {
+        char *buffer;                             /**< staging buffer */
+        uint16_t size;                            /**< staging buffer size */
+        uint16_t length;                          /**< staged length */
+        uint8_t hold;                             /**< staging depth, write through if 0 */
+#if SHELL_OUTPUT_BUFFER > 0
+        char data[SHELL_OUTPUT_BUFFER];           /**< default staging buffer */
+#endif
+    } output;
+
     /*! shell status */
     struct {
         uint8_t tab_flag   : 1;             /**< tab flag */
@@ -189,6 +200,8 @@ void shell_init(shell_t *shell, char *buffer, uint16_t size);
 
 uint16_t shell_write_string(shell_t *shell, const char *string);
 
+void shell_write_flush(shell_t *shell);
+
 void shell_handler(shell_t *shell, char data);
 
 void shell_task(void *param);
@@ -205,20 +218,6 @@ shell_cmd_t *shell_seek_cmd(shell_t *shell,
 /*------------------------------- shell register -----------------------------*/                            
 /*-----------------------------------------------------------------------------*/                            
 /*-----------------------------------------------------------------------------*/                            
-/**
- * ---------------------------------------
- *  number type
- * ---------------------------------------
- */
-typedef enum shell_num_type_e
-{
-    NUM_TYPE_DEC,                      /**< decimal */
-    NUM_TYPE_BIN,                      /**< binary */
-    NUM_TYPE_OCT,                      /**< octal */
-    NUM_TYPE_HEX,                      /**< hex */
-    NUM_TYPE_FLOAT                     /**< float */
-} SHELL_NUM_TYPE_E;
-
 int shell_register_run(shell_t *shell, shell_cmd_t *command, int argc, char *argv[]);
 
 #endif/**< __SHELL_H__ */
@@ -29,4 +29,14 @@
 
 #define  SHELL_TASK_WHILE                      1           /**< whether to use default shell task while loop */
 
+#define  SHELL_OUTPUT_BUFFER                   64          /**< shell output staging buffer size, 0 to write through */
+
+#ifndef  SHELL_SECTION_BOUNDS
+#if defined(__linux__)
+#define  SHELL_SECTION_BOUNDS                  1           /**< linux host, gnu ld bounds */
+#else
+#define  SHELL_SECTION_BOUNDS                  0           /**< section bounds symbols, 0 `shell_sec$$Base`/`$$Limit`, 1 gnu ld `__start_shell_sec`/`__stop_shell_sec`, 2 linker script `_shell_command_start`/`_end` */
+#endif
+#endif
+
 #endif
@@ -10,6 +10,8 @@
  * |   Date    |  version  |  author   | Description  |
  * |2025-10-28 |    1.1    |  awesome  | init version |
  * |2025-11-03 |    5.1    |  awesome  | add weak attr|
+ * |2026-10-18 |    5.2    |  awesome  | add tx ring  |
+ * |2026-10-18 |    5.3    |  awesome  | add rx ring  |
  * ********************************************************
  */
 #include "zshell_port.h"
@@ -17,6 +19,10 @@
 
 shell_t shell;
 uint8_t shell_buffer[512];
+shell_ring_t shell_tx_ring;
+static uint8_t shell_tx_buffer[SHELL_TX_BUFFER_SIZE];
+shell_ring_t shell_rx_ring;
+static uint8_t shell_rx_buffer[SHELL_RX_BUFFER_SIZE];
 
 __attribute__((weak)) int uart_send_byte(uint8_t *data, uint32_t size)
 {
@@ -40,18 +46,136 @@ __attribute__((weak)) int uart_receive(uint8_t *data, uint32_t size)
     return 1;
 }
 
+/**
+ * @brief start draining tx ring, called after every write and
+ *        again while waiting for space with SHELL_RING_POLICY_BLOCK
+ */
+__attribute__((weak)) void shell_tx_kick(shell_ring_t *ring)
+{
+#if SHELL_TX_USING_IRQ == 1
+    /*! USART1_IRQHandler calls shell_tx_isr() */
+    USART_ITConfig(USART1, USART_IT_TXE, ENABLE);
+#else
+    uint8_t *data;
+    uint16_t length;
+
+    /*! no tx irq, drain in caller context */
+    while((length = shell_ring_peek(ring, &data)) > 0) {
+        uart_send_byte(data, length);
+        shell_ring_skip(ring, length);
+    }
+#endif
+}
+
+/**
+ * @brief get next byte to send, for uart tx irq
+ * @return 1 byte got, 0 ring empty, disable tx irq
+ */
+int shell_tx_isr_byte(uint8_t *data)
+{
+    return shell_ring_read(&shell_tx_ring, data, 1);
+}
+
+/**
+ * @brief release sent block and get next block, for dma complete callback
+ * @param sent bytes of last block, 0 for first block
+ * @return next block length, 0 ring empty
+ */
+uint16_t shell_tx_dma_next(uint16_t sent, uint8_t **data)
+{
+    shell_ring_skip(&shell_tx_ring, sent);
+    return shell_ring_peek(&shell_tx_ring, data);
+}
+
+#if SHELL_RX_USING_IRQ == 1
+/**
+ * @brief uart rx irq handler, call in USART1_IRQHandler,
+ *        USART_IT_RXNE should be enabled
+ */
+void shell_rx_isr(void)
+{
+    if(USART_GetITStatus(USART1, USART_IT_RXNE) != RESET)
+    {
+        shell_rx_isr_byte(USART_ReceiveData(USART1));
+    }
+}
+#endif
+
+#if SHELL_TX_USING_IRQ == 1
+/**
+ * @brief uart tx irq handler, call in USART1_IRQHandler
+ */
+void shell_tx_isr(void)
+{
+    uint8_t data;
+
+    if(USART_GetITStatus(USART1, USART_IT_TXE) != RESET)
+    {
+        if(shell_tx_isr_byte(&data))
+        {
+            USART_SendData(USART1, data);
+        }
+        else
+        {
+            USART_ITConfig(USART1, USART_IT_TXE, DISABLE);
+        }
+    }
+}
+#endif
+
 int shell_write(uint8_t *data, uint16_t size)
 {
-    return uart_send_byte(data, size);
+    return shell_ring_push(&shell_tx_ring, data, size,
+                           SHELL_TX_POLICY, shell_tx_kick);
+}
+
+/**
+ * @brief wait for rx data, called by shell task when rx ring is empty,
+ *        override to take a semaphore on rtos
+ */
+__attribute__((weak)) void shell_rx_wait(void)
+{
+}
+
+/**
+ * @brief notify rx data, called by uart rx irq after filling rx ring,
+ *        override to give the semaphore of shell_rx_wait from isr
+ */
+__attribute__((weak)) void shell_rx_notify(void)
+{
+}
+
+/**
+ * @brief put received byte into rx ring, for uart rx irq
+ * @return 1 byte stored, 0 ring full, byte dropped
+ */
+int shell_rx_isr_byte(uint8_t data)
+{
+    int ret = shell_ring_write(&shell_rx_ring, &data, 1);
+    if(!ret) {
+        shell_rx_ring.dropped++;
+    }
+    shell_rx_notify();
+    return ret;
 }
 
 int shell_read(uint8_t *data, uint16_t size)
 {
+#if SHELL_RX_USING_IRQ == 1
+    /*! bytes typed while a command runs stay in rx ring */
+    while(shell_ring_used(&shell_rx_ring) == 0) {
+        shell_rx_wait();
+    }
+    return shell_ring_read(&shell_rx_ring, data, size);
+#else
     return uart_receive(data, size);
+#endif
 }
 
 void init_shell(void)
 {
+    shell_ring_init(&shell_tx_ring, shell_tx_buffer, SHELL_TX_BUFFER_SIZE);
+    shell_ring_init(&shell_rx_ring, shell_rx_buffer, SHELL_RX_BUFFER_SIZE);
     shell.write = shell_write;
     shell.read = shell_read;
     shell_init(&shell, shell_buffer, 512);
@@ -16,8 +16,50 @@
 #define __SHELL_PORT_H__
 
 #include "zshell.h"
+#include "shell_ring.h"
+
+#ifndef SHELL_TX_BUFFER_SIZE
+#define SHELL_TX_BUFFER_SIZE               1024        /**< tx ring size, power of 2 */
+#endif
+
+#ifndef SHELL_TX_POLICY
+#define SHELL_TX_POLICY                    SHELL_RING_POLICY_BLOCK  /**< tx policy when ring is full */
+#endif
+
+#ifndef SHELL_TX_USING_IRQ
+#define SHELL_TX_USING_IRQ                 0           /**< whether tx ring is drained by uart irq */
+#endif
+
+#ifndef SHELL_RX_BUFFER_SIZE
+#define SHELL_RX_BUFFER_SIZE               256         /**< rx ring size, power of 2 */
+#endif
+
+#ifndef SHELL_RX_USING_IRQ
+#define SHELL_RX_USING_IRQ                 0           /**< whether rx ring is filled by uart irq */
+#endif
+
 extern shell_t shell;
+extern shell_ring_t shell_tx_ring;
+extern shell_ring_t shell_rx_ring;
 
 void init_shell(void);
 
+int shell_tx_isr_byte(uint8_t *data);
+
+uint16_t shell_tx_dma_next(uint16_t sent, uint8_t **data);
+
+int shell_rx_isr_byte(uint8_t data);
+
+void shell_rx_wait(void);
+
+void shell_rx_notify(void);
+
+#if SHELL_RX_USING_IRQ == 1
+void shell_rx_isr(void);
+#endif
+
+#if SHELL_TX_USING_IRQ == 1
+void shell_tx_isr(void);
+#endif
+
 #endif /*< __SHELL_PORT_H__ */